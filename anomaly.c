@@ -0,0 +1,243 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Anomaly Detection Module
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Keep rolling short and long windows per metric with running
+ *   mean/variance, updated in O(1) per sample (no rescans).
+ * - Keep an EWMA mean/variance per metric.
+ * - Score every new reading against the windows and EWMA *before* adding
+ *   it, and emit an AnomalyEvent when any |z| exceeds the threshold.
+ *
+ * One AnomalyDetector is one series (station); window lengths are in
+ * samples, so minute data uses e.g. 24 * 60 and 7 * 24 * 60.
+ *
+ * Functions:
+ * - init_anomaly_detector(AnomalyDetector*, short_window, long_window, z_threshold)
+ * - anomaly_detector_update(AnomalyDetector*, date_str, TemperatureLog*, callback, context)
+ * - destroy_anomaly_detector(AnomalyDetector*)
+ */
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#include <stdio.h>  // for printf()
+#include <stdlib.h> // for malloc(), free()
+#include <string.h> // for memset()
+#include <math.h>   // for sqrt(), fabs()
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal helpers
+// --------------------------------------------------
+
+#define ANOMALY_MIN_STDDEV 0.05 // avoid huge z-scores on flat series
+
+static int init_window(RollingWindow *window, int capacity)
+{
+    memset(window, 0, sizeof(*window));
+    window->samples = (float *)malloc(sizeof(float) * capacity);
+    if (!window->samples)
+    {
+        printf("ERROR: Failed to allocate rolling window of %d samples.\n", capacity);
+        return -1;
+    }
+    window->capacity = capacity;
+    return 0;
+}
+
+// exact mean/m2 from the ring, run once per window length to stop the
+// incremental updates from drifting (amortized O(1) per sample)
+static void resync_window(RollingWindow *window)
+{
+    double sum = 0.0;
+    for (int i = 0; i < window->count; i++)
+        sum += window->samples[i];
+    window->mean = sum / window->count;
+
+    double m2 = 0.0;
+    for (int i = 0; i < window->count; i++)
+    {
+        double d = window->samples[i] - window->mean;
+        m2 += d * d;
+    }
+    window->m2 = m2;
+}
+
+// add x; once full, x replaces the oldest sample (Welford add / slide)
+static void window_push(RollingWindow *window, float x)
+{
+    if (window->count < window->capacity)
+    {
+        window->samples[window->next] = x;
+        window->count++;
+        double delta = x - window->mean;
+        window->mean += delta / window->count;
+        window->m2 += delta * (x - window->mean);
+    }
+    else
+    {
+        float old = window->samples[window->next];
+        window->samples[window->next] = x;
+        double old_mean = window->mean;
+        window->mean += ((double)x - old) / window->count;
+        window->m2 += ((double)x - old) * ((double)x - window->mean + old - old_mean);
+        if (window->m2 < 0.0)
+            window->m2 = 0.0;
+    }
+
+    window->next++;
+    if (window->next == window->capacity)
+    {
+        window->next = 0;
+        resync_window(window);
+    }
+}
+
+// z-score of x against a full window (0 while the window is warming up)
+static double window_z(RollingWindow *window, float x)
+{
+    if (window->count < window->capacity || window->count < 2)
+        return 0.0;
+
+    double stddev = sqrt(window->m2 / (window->count - 1));
+    if (stddev < ANOMALY_MIN_STDDEV)
+        stddev = ANOMALY_MIN_STDDEV;
+    return (x - window->mean) / stddev;
+}
+
+// z-score against the EWMA, then fold x into it
+static double ewma_update(MetricDetector *metric, float x, int warmup)
+{
+    double z = 0.0;
+    if (metric->samples == 0)
+    {
+        metric->ewma_mean = x;
+        metric->ewma_var = 0.0;
+    }
+    else
+    {
+        double delta = x - metric->ewma_mean;
+        if (metric->samples >= warmup)
+        {
+            double stddev = sqrt(metric->ewma_var);
+            if (stddev < ANOMALY_MIN_STDDEV)
+                stddev = ANOMALY_MIN_STDDEV;
+            z = delta / stddev;
+        }
+        metric->ewma_mean += ANOMALY_EWMA_ALPHA * delta;
+        metric->ewma_var = (1.0 - ANOMALY_EWMA_ALPHA) *
+                           (metric->ewma_var + ANOMALY_EWMA_ALPHA * delta * delta);
+    }
+    metric->samples++;
+    return z;
+}
+
+// --------------------------------------------------
+// detector functions
+// --------------------------------------------------
+
+int init_anomaly_detector(AnomalyDetector *detector, int short_window,
+                          int long_window, double z_threshold)
+{
+    memset(detector, 0, sizeof(*detector));
+    if (short_window < 2)
+        short_window = ANOMALY_SHORT_WINDOW;
+    if (long_window < short_window)
+        long_window = ANOMALY_LONG_WINDOW;
+    detector->z_threshold = z_threshold > 0.0 ? z_threshold : ANOMALY_Z_THRESHOLD;
+
+    for (int m = 0; m < ANOMALY_METRICS; m++)
+    {
+        if (init_window(&detector->metrics[m].short_window, short_window) != 0 ||
+            init_window(&detector->metrics[m].long_window, long_window) != 0)
+        {
+            destroy_anomaly_detector(detector);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// score one reading on every metric, report anomalies, then learn from it
+// returns number of anomaly events emitted for this reading
+int anomaly_detector_update(AnomalyDetector *detector, const char *date_str,
+                            TemperatureLog *entry, AnomalyCallback callback,
+                            void *context)
+{
+    float values[ANOMALY_METRICS] = {entry->temperature, entry->humidity, entry->wind_speed};
+    int events = 0;
+
+    for (int m = 0; m < ANOMALY_METRICS; m++)
+    {
+        MetricDetector *metric = &detector->metrics[m];
+        float x = values[m];
+
+        AnomalyEvent event;
+        event.z_short = window_z(&metric->short_window, x);
+        event.z_long = window_z(&metric->long_window, x);
+        event.z_ewma = ewma_update(metric, x, metric->short_window.capacity);
+
+        window_push(&metric->short_window, x);
+        window_push(&metric->long_window, x);
+
+        if (fabs(event.z_short) > detector->z_threshold ||
+            fabs(event.z_long) > detector->z_threshold ||
+            fabs(event.z_ewma) > detector->z_threshold)
+        {
+            event.date_str = date_str;
+            event.hour = entry->hour;
+            event.metric = (WeatherMetric)m;
+            event.value = x;
+            events++;
+            if (callback)
+                callback(&event, context);
+        }
+    }
+
+    detector->samples++;
+    detector->anomalies += events;
+    return events;
+}
+
+void destroy_anomaly_detector(AnomalyDetector *detector)
+{
+    if (!detector)
+        return;
+    for (int m = 0; m < ANOMALY_METRICS; m++)
+    {
+        free(detector->metrics[m].short_window.samples);
+        free(detector->metrics[m].long_window.samples);
+        detector->metrics[m].short_window.samples = NULL;
+        detector->metrics[m].long_window.samples = NULL;
+    }
+}
@@ -0,0 +1,319 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Columnar Export Module
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Export a WeatherSystem column by column: dates, hourly temperature,
+ *   humidity and wind, then daily avg/min/max, each a contiguous block.
+ * - Footer with the offset and size of every column, so readers can
+ *   mmap the file and touch only the columns they project.
+ *
+ * Layout (native byte order, blocks aligned to COLUMNAR_ALIGN):
+ *   header  : magic "WLCOLv1", version, days
+ *   columns : COLUMN_DATE .. COLUMN_MAX_TEMPERATURE
+ *   footer  : ColumnarColumn[COLUMN_COUNT]
+ *   trailer : footer offset (uint64), column count (uint32), "WLC1"
+ *
+ * Functions:
+ * - save_system_columnar(WeatherSystem*, const char *filename)
+ * - columnar_open(ColumnarFile*, const char *filename)
+ * - columnar_column(ColumnarFile*, ColumnId, size_t *count)
+ * - parse_column_name(const char *name, ColumnId*)
+ * - columnar_close(ColumnarFile*)
+ */
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#define _POSIX_C_SOURCE 200809L // for mmap(), fstat() in strict C modes
+
+#include <stdio.h>  // for printf(), fwrite()
+#include <stdlib.h> // for malloc(), free()
+#include <string.h> // for memcmp(), memset(), strcmp()
+#if !defined(_WIN32)
+#include <fcntl.h>    // for open()
+#include <sys/mman.h> // for mmap(), munmap()
+#include <sys/stat.h> // for fstat()
+#include <unistd.h>   // for close()
+#endif
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal types and helpers
+// --------------------------------------------------
+
+#define COLUMNAR_TRAILER_MAGIC 0x31434C57u // "WLC1" little endian
+
+typedef struct ColumnarHeader
+{
+    char magic[COLUMNAR_MAGIC_LEN]; // COLUMNAR_MAGIC
+    uint32_t version;               // COLUMNAR_VERSION
+    uint32_t days;                  // Days stored
+} ColumnarHeader;
+
+typedef struct ColumnarTrailer
+{
+    uint64_t footer_offset; // Start of ColumnarColumn[columns]
+    uint32_t columns;       // Footer entries
+    uint32_t magic;         // COLUMNAR_TRAILER_MAGIC
+} ColumnarTrailer;
+
+static const char *column_names[COLUMN_COUNT] = {
+    "date", "temp", "humidity", "wind", "avg", "min", "max"};
+
+// pad the stream with zeros up to the next aligned offset
+static long columnar_align(FILE *fptr)
+{
+    static const char zeros[COLUMNAR_ALIGN] = {0};
+    long pos = ftell(fptr);
+    long pad = (COLUMNAR_ALIGN - pos % COLUMNAR_ALIGN) % COLUMNAR_ALIGN;
+    fwrite(zeros, 1, pad, fptr);
+    return pos + pad;
+}
+
+// one value of an hourly or daily float column
+static float column_value(DailyWeatherLog *daily_log, ColumnId column, int hour)
+{
+    switch (column)
+    {
+    case COLUMN_TEMPERATURE:
+        return daily_log->entries[hour].temperature;
+    case COLUMN_HUMIDITY:
+        return daily_log->entries[hour].humidity;
+    case COLUMN_WIND_SPEED:
+        return daily_log->entries[hour].wind_speed;
+    case COLUMN_AVG_TEMPERATURE:
+        return daily_log->avg_temperature;
+    case COLUMN_MIN_TEMPERATURE:
+        return daily_log->min_temperature;
+    default:
+        return daily_log->max_temperature;
+    }
+}
+
+// --------------------------------------------------
+// columnar functions
+// --------------------------------------------------
+
+// write weather_system as a columnar file (replaces filename)
+int save_system_columnar(WeatherSystem *weather_system, const char *filename)
+{
+    FILE *fptr;
+    FOPEN(fptr, filename, "wb");
+    if (fptr == NULL)
+    {
+        printf("ERROR: Could not open file '%s' for writing.\n", filename);
+        return -1;
+    }
+
+    int days = weather_system->days_logged;
+    ColumnarHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, COLUMNAR_MAGIC, COLUMNAR_MAGIC_LEN);
+    header.version = COLUMNAR_VERSION;
+    header.days = (uint32_t)days;
+    fwrite(&header, sizeof(header), 1, fptr);
+
+    ColumnarColumn footer[COLUMN_COUNT];
+    for (int c = 0; c < COLUMN_COUNT; c++)
+    {
+        ColumnId column = (ColumnId)c;
+        int hourly = column == COLUMN_TEMPERATURE || column == COLUMN_HUMIDITY ||
+                     column == COLUMN_WIND_SPEED;
+
+        footer[c].column = (uint32_t)c;
+        footer[c].offset = (uint64_t)columnar_align(fptr);
+        footer[c].elem_size = column == COLUMN_DATE ? DATE_LEN : sizeof(float);
+        footer[c].count = (uint64_t)days * (hourly ? DAILY_LOG : 1);
+
+        for (int d = 0; d < days; d++)
+        {
+            DailyWeatherLog *daily_log = &weather_system->logs[d];
+            if (column == COLUMN_DATE)
+            {
+                fwrite(daily_log->date_str, DATE_LEN, 1, fptr);
+                continue;
+            }
+
+            float values[DAILY_LOG];
+            int n = hourly ? DAILY_LOG : 1;
+            for (int h = 0; h < n; h++)
+                values[h] = column_value(daily_log, column, h);
+            fwrite(values, sizeof(float), n, fptr);
+        }
+    }
+
+    ColumnarTrailer trailer;
+    trailer.footer_offset = (uint64_t)columnar_align(fptr);
+    trailer.columns = COLUMN_COUNT;
+    trailer.magic = COLUMNAR_TRAILER_MAGIC;
+    fwrite(footer, sizeof(footer), 1, fptr);
+    fwrite(&trailer, sizeof(trailer), 1, fptr);
+
+    int failed = ferror(fptr);
+    if (fclose(fptr) != 0 || failed)
+    {
+        printf("ERROR: Could not write columnar file '%s'.\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+// map a columnar file and validate its header and footer
+int columnar_open(ColumnarFile *file, const char *filename)
+{
+    memset(file, 0, sizeof(*file));
+
+#if defined(_WIN32)
+    // no mmap: read the whole file instead
+    FILE *fptr;
+    FOPEN(fptr, filename, "rb");
+    if (fptr == NULL)
+    {
+        printf("ERROR: Could not open file '%s' for reading.\n", filename);
+        return -1;
+    }
+    fseek(fptr, 0, SEEK_END);
+    file->size = (size_t)ftell(fptr);
+    rewind(fptr);
+    file->base = (unsigned char *)malloc(file->size ? file->size : 1);
+    if (!file->base || fread(file->base, 1, file->size, fptr) != file->size)
+    {
+        fclose(fptr);
+        columnar_close(file);
+        return -1;
+    }
+    fclose(fptr);
+#else
+    int fd = open(filename, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        printf("ERROR: Could not open file '%s' for reading.\n", filename);
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    file->size = (size_t)st.st_size;
+    if (file->size > 0)
+    {
+        void *base = mmap(NULL, file->size, PROT_READ, MAP_SHARED, fd, 0);
+        file->base = base == MAP_FAILED ? NULL : (unsigned char *)base;
+    }
+    close(fd);
+#endif
+
+    ColumnarHeader *header = (ColumnarHeader *)file->base;
+    if (!file->base || file->size < sizeof(ColumnarHeader) + sizeof(ColumnarTrailer) ||
+        memcmp(header->magic, COLUMNAR_MAGIC, COLUMNAR_MAGIC_LEN) != 0 ||
+        header->version != COLUMNAR_VERSION)
+    {
+        printf("ERROR: '%s' is not a columnar weather file.\n", filename);
+        columnar_close(file);
+        return -1;
+    }
+
+    // footer between the header and the trailer (no overflow in the sums)
+    ColumnarTrailer trailer;
+    size_t footer_size = sizeof(ColumnarColumn) * COLUMN_COUNT;
+    memcpy(&trailer, file->base + file->size - sizeof(trailer), sizeof(trailer));
+    if (trailer.magic != COLUMNAR_TRAILER_MAGIC || trailer.columns != COLUMN_COUNT ||
+        file->size - sizeof(trailer) < sizeof(ColumnarHeader) + footer_size ||
+        trailer.footer_offset < sizeof(ColumnarHeader) ||
+        trailer.footer_offset > file->size - sizeof(trailer) - footer_size)
+    {
+        printf("ERROR: Damaged footer in columnar file '%s'.\n", filename);
+        columnar_close(file);
+        return -1;
+    }
+    memcpy(file->columns, file->base + trailer.footer_offset, sizeof(file->columns));
+    file->days = header->days;
+
+    // readers index the blocks as float or char[DATE_LEN] arrays of the
+    // day count: sizes, counts and bounds must match exactly
+    for (int c = 0; c < COLUMN_COUNT; c++)
+    {
+        ColumnarColumn *col = &file->columns[c];
+        int hourly = c == COLUMN_TEMPERATURE || c == COLUMN_HUMIDITY ||
+                     c == COLUMN_WIND_SPEED;
+        uint32_t elem_size = c == COLUMN_DATE ? DATE_LEN : (uint32_t)sizeof(float);
+        uint64_t count = (uint64_t)file->days * (hourly ? DAILY_LOG : 1);
+        if (col->column != (uint32_t)c || col->elem_size != elem_size ||
+            col->count != count || col->offset % COLUMNAR_ALIGN != 0 ||
+            col->offset < sizeof(ColumnarHeader) || col->offset > trailer.footer_offset ||
+            col->count > (trailer.footer_offset - col->offset) / col->elem_size)
+        {
+            printf("ERROR: Damaged column %d in columnar file '%s'.\n", c, filename);
+            columnar_close(file);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// pointer to one column's values (float, or char[DATE_LEN] for COLUMN_DATE);
+// only the pages of that column are read from disk
+const void *columnar_column(ColumnarFile *file, ColumnId column, size_t *count)
+{
+    if (!file || !file->base || column < 0 || column >= COLUMN_COUNT)
+        return NULL;
+    if (count)
+        *count = (size_t)file->columns[column].count;
+    return file->base + file->columns[column].offset;
+}
+
+// "date", "temp", "humidity", "wind", "avg", "min", "max"; returns 0 if known
+int parse_column_name(const char *name, ColumnId *column)
+{
+    for (int c = 0; c < COLUMN_COUNT; c++)
+    {
+        if (strcmp(name, column_names[c]) == 0)
+        {
+            *column = (ColumnId)c;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+void columnar_close(ColumnarFile *file)
+{
+    if (!file || !file->base)
+        return;
+#if defined(_WIN32)
+    free(file->base);
+#else
+    munmap(file->base, file->size);
+#endif
+    file->base = NULL;
+    file->size = 0;
+}
@@ -0,0 +1,446 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Correlation Report Module
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Mean, variance, covariance and Pearson correlation of temperature,
+ *   humidity and wind, per day and over a whole range.
+ * - Lagged autocorrelation of hourly temperature (x[t] vs x[t + lag]).
+ * - One fused pass: a TemperatureLog is 16 bytes, so each reading is a
+ *   single 4-float SSE load (hour lane masked off) that updates the sums,
+ *   squares and cross products of all three metrics together.
+ * - Per-day sums are shifted by the day's first reading (no cancellation
+ *   in float), then folded into double moments with Chan's parallel
+ *   update, which also merges threads, segments or files.
+ *
+ * Days are sorted by date and repeated dates dropped (the last copy wins,
+ * as in --compact) before anything is computed. A lag pair joins hour h
+ * of date D with the hour lag later by the calendar, so a missing day
+ * gives no pair rather than one with an unrelated day. The pair starting
+ * in day d belongs to the thread that owns d, even if its second reading
+ * lies in the next thread's days.
+ *
+ * Functions:
+ * - init_correlation_report(CorrelationReport*, lag_hours)
+ * - day_moments(DailyWeatherLog*, MetricMoments*)
+ * - merge_metric_moments(MetricMoments *into, MetricMoments *from)
+ * - merge_correlation_report(CorrelationReport *into, CorrelationReport *from)
+ * - moments_correlation(MetricMoments*, pair)
+ * - lag_correlation(LagMoments*)
+ * - correlation_report(WeatherSystem*, from, to, lag_hours, threads,
+ *                      CorrelationReport*)
+ */
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#include <stdio.h>   // for printf(), sscanf()
+#include <stdlib.h>  // for malloc(), free()
+#include <string.h>  // for memset(), strcmp()
+#include <math.h>    // for sqrt()
+#include <pthread.h> // for pthread_create(), pthread_join()
+#if defined(__SSE2__)
+#include <emmintrin.h> // for _mm_loadu_ps(), _mm_mul_ps(), _mm_shuffle_ps()
+#endif
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal types and helpers
+// --------------------------------------------------
+
+// one thread's share of the days
+typedef struct CorrelationTask
+{
+    WeatherSystem *weather_system;
+    const long *day_numbers; // Calendar day of every day, -1 if unparsable
+    int range_first;         // Days lag pairs may reach: range_first ..
+    int range_last;          // .. range_last - 1
+    int first_day;           // First day of this thread
+    int last_day;            // One past the last day
+    CorrelationReport report;
+} CorrelationTask;
+
+// metric pairs of MetricMoments.comoment
+static const int pair_metrics[CORRELATION_PAIRS][2] = {{0, 1}, {1, 2}, {0, 2}};
+
+// days since 0000-03-01 of a "YYYY-MM-DD" date, -1 if it does not parse
+static long date_day_number(const char *date_str)
+{
+    int y, m, d;
+    if (sscanf(date_str, "%d-%d-%d", &y, &m, &d) != 3 || y < 0 ||
+        m < 1 || m > 12 || d < 1 || d > 31)
+        return -1;
+
+    // civil calendar from March, so the leap day ends the year
+    if (m <= 2)
+        y--;
+    if (y < 0)
+        return -1;
+    long month = (m + 9) % 12;
+    return 365L * y + y / 4 - y / 100 + y / 400 + (153 * month + 2) / 5 + d - 1;
+}
+
+// index of the day with calendar number `number` in days lo .. end - 1, or -1
+static int find_day_number(const long *numbers, int lo, int end, long number)
+{
+    int hi = end;
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        if (numbers[mid] < number)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < end && numbers[lo] == number ? lo : -1;
+}
+
+// Chan et al.: combine moments of two disjoint sets of pairs
+static void merge_lag_moments(LagMoments *into, LagMoments *from)
+{
+    if (from->n == 0.0)
+        return;
+    if (into->n == 0.0)
+    {
+        *into = *from;
+        return;
+    }
+
+    double n = into->n + from->n;
+    double weight = into->n * from->n / n;
+    double delta[2];
+    for (int i = 0; i < 2; i++)
+    {
+        delta[i] = from->mean[i] - into->mean[i];
+        into->mean[i] += delta[i] * from->n / n;
+        into->m2[i] += from->m2[i] + delta[i] * delta[i] * weight;
+    }
+    into->comoment += from->comoment + delta[0] * delta[1] * weight;
+    into->n = n;
+}
+
+// moments of the pairs (x[t], x[t + lag]) for the hours t of one day;
+// only pairs whose second reading is a day inside the range are counted
+static void day_lag_moments(CorrelationTask *task, int day, int lag_hours, LagMoments *lag)
+{
+    memset(lag, 0, sizeof(*lag));
+    long number = task->day_numbers[day];
+    if (number < 0)
+        return;
+
+    // x[t + lag] may sit in one of the next days: gather both series
+    DailyWeatherLog *logs = task->weather_system->logs;
+    float xs[DAILY_LOG], ys[DAILY_LOG];
+    int count = 0;
+    long target_offset = -1;
+    int target = -1;
+    for (int h = 0; h < DAILY_LOG; h++)
+    {
+        long t = (long)h + lag_hours;
+        if (t / DAILY_LOG != target_offset)
+        {
+            target_offset = t / DAILY_LOG;
+            // dates are unique, so day + k days is at most k entries ahead
+            long end = day + target_offset + 1;
+            target = find_day_number(task->day_numbers, day,
+                                     end < task->range_last ? (int)end : task->range_last,
+                                     number + target_offset);
+        }
+        if (target < 0)
+            continue;
+        xs[count] = logs[day].entries[h].temperature;
+        ys[count] = logs[target].entries[t % DAILY_LOG].temperature;
+        count++;
+    }
+    if (count == 0)
+        return;
+
+    float kx = xs[0], ky = ys[0];
+    float sx = 0.0f, sy = 0.0f, sxx = 0.0f, syy = 0.0f, sxy = 0.0f;
+    int h = 0;
+#if defined(__SSE2__)
+    __m128 vkx = _mm_set1_ps(kx), vky = _mm_set1_ps(ky);
+    __m128 vsx = _mm_setzero_ps(), vsy = _mm_setzero_ps();
+    __m128 vsxx = _mm_setzero_ps(), vsyy = _mm_setzero_ps(), vsxy = _mm_setzero_ps();
+    for (; h + 4 <= count; h += 4)
+    {
+        __m128 x = _mm_sub_ps(_mm_loadu_ps(xs + h), vkx);
+        __m128 y = _mm_sub_ps(_mm_loadu_ps(ys + h), vky);
+        vsx = _mm_add_ps(vsx, x);
+        vsy = _mm_add_ps(vsy, y);
+        vsxx = _mm_add_ps(vsxx, _mm_mul_ps(x, x));
+        vsyy = _mm_add_ps(vsyy, _mm_mul_ps(y, y));
+        vsxy = _mm_add_ps(vsxy, _mm_mul_ps(x, y));
+    }
+    float lanes[5][4];
+    _mm_storeu_ps(lanes[0], vsx);
+    _mm_storeu_ps(lanes[1], vsy);
+    _mm_storeu_ps(lanes[2], vsxx);
+    _mm_storeu_ps(lanes[3], vsyy);
+    _mm_storeu_ps(lanes[4], vsxy);
+    for (int l = 0; l < 4; l++)
+    {
+        sx += lanes[0][l];
+        sy += lanes[1][l];
+        sxx += lanes[2][l];
+        syy += lanes[3][l];
+        sxy += lanes[4][l];
+    }
+#endif
+    for (; h < count; h++)
+    {
+        float x = xs[h] - kx, y = ys[h] - ky;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        syy += y * y;
+        sxy += x * y;
+    }
+
+    double n = (double)count;
+    lag->n = n;
+    lag->mean[0] = kx + sx / n;
+    lag->mean[1] = ky + sy / n;
+    lag->m2[0] = fmax(sxx - (double)sx * sx / n, 0.0);
+    lag->m2[1] = fmax(syy - (double)sy * sy / n, 0.0);
+    lag->comoment = sxy - (double)sx * sy / n;
+}
+
+static void *correlation_worker(void *arg)
+{
+    CorrelationTask *task = (CorrelationTask *)arg;
+    CorrelationReport *report = &task->report;
+
+    for (int d = task->first_day; d < task->last_day; d++)
+    {
+        MetricMoments day;
+        LagMoments lag;
+        day_moments(&task->weather_system->logs[d], &day);
+        day_lag_moments(task, d, report->lag_hours, &lag);
+        merge_metric_moments(&report->moments, &day);
+        merge_lag_moments(&report->lag, &lag);
+    }
+    return NULL;
+}
+
+static double pearson(double m2_a, double m2_b, double comoment)
+{
+    double denominator = sqrt(m2_a * m2_b);
+    return denominator > 0.0 ? comoment / denominator : 0.0;
+}
+
+// --------------------------------------------------
+// correlation functions
+// --------------------------------------------------
+
+void init_correlation_report(CorrelationReport *report, int lag_hours)
+{
+    memset(report, 0, sizeof(*report));
+    report->lag_hours = lag_hours < 1 ? CORRELATION_DEFAULT_LAG : lag_hours;
+}
+
+// moments of the 24 readings of one day, in one pass over the entries
+void day_moments(DailyWeatherLog *daily_log, MetricMoments *moments)
+{
+    // shifted sums: s = sum(v - k), sq = sum((v - k)^2), cross = pair products
+    // lane 0 is the hour (unused); lanes 1-3 temperature, humidity, wind
+    float k[4], s[4], sq[4], cross[4];
+    k[0] = 0.0f;
+    k[1] = daily_log->entries[0].temperature;
+    k[2] = daily_log->entries[0].humidity;
+    k[3] = daily_log->entries[0].wind_speed;
+
+#if defined(__SSE2__)
+    const __m128 metrics = _mm_castsi128_ps(_mm_set_epi32(-1, -1, -1, 0));
+    __m128 vk = _mm_loadu_ps(k);
+    __m128 vs = _mm_setzero_ps(), vsq = _mm_setzero_ps(), vcross = _mm_setzero_ps();
+    for (int h = 0; h < DAILY_LOG; h++)
+    {
+        // one TemperatureLog = one register (hour, temperature, humidity, wind)
+        __m128 v = _mm_loadu_ps((const float *)&daily_log->entries[h]);
+        v = _mm_sub_ps(_mm_and_ps(v, metrics), vk);
+        // (0, humidity, wind, temperature): products give T*H, H*W, W*T
+        __m128 rotated = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 3, 2, 0));
+        vs = _mm_add_ps(vs, v);
+        vsq = _mm_add_ps(vsq, _mm_mul_ps(v, v));
+        vcross = _mm_add_ps(vcross, _mm_mul_ps(v, rotated));
+    }
+    _mm_storeu_ps(s, vs);
+    _mm_storeu_ps(sq, vsq);
+    _mm_storeu_ps(cross, vcross);
+#else
+    memset(s, 0, sizeof(s));
+    memset(sq, 0, sizeof(sq));
+    memset(cross, 0, sizeof(cross));
+    for (int h = 0; h < DAILY_LOG; h++)
+    {
+        TemperatureLog *entry = &daily_log->entries[h];
+        float v[4] = {0.0f, entry->temperature - k[1], entry->humidity - k[2],
+                      entry->wind_speed - k[3]};
+        for (int i = 1; i < 4; i++)
+        {
+            s[i] += v[i];
+            sq[i] += v[i] * v[i];
+        }
+        cross[1] += v[1] * v[2];
+        cross[2] += v[2] * v[3];
+        cross[3] += v[3] * v[1];
+    }
+#endif
+
+    double n = DAILY_LOG;
+    moments->n = n;
+    for (int m = 0; m < ANOMALY_METRICS; m++)
+    {
+        moments->mean[m] = k[m + 1] + s[m + 1] / n;
+        moments->m2[m] = fmax(sq[m + 1] - (double)s[m + 1] * s[m + 1] / n, 0.0);
+    }
+    for (int p = 0; p < CORRELATION_PAIRS; p++)
+    {
+        int a = pair_metrics[p][0] + 1, b = pair_metrics[p][1] + 1;
+        moments->comoment[p] = cross[p + 1] - (double)s[a] * s[b] / n;
+    }
+}
+
+// Chan et al.: combine moments of two disjoint sets of readings
+void merge_metric_moments(MetricMoments *into, MetricMoments *from)
+{
+    if (from->n == 0.0)
+        return;
+    if (into->n == 0.0)
+    {
+        *into = *from;
+        return;
+    }
+
+    double n = into->n + from->n;
+    double weight = into->n * from->n / n;
+    double delta[ANOMALY_METRICS];
+    for (int m = 0; m < ANOMALY_METRICS; m++)
+    {
+        delta[m] = from->mean[m] - into->mean[m];
+        into->mean[m] += delta[m] * from->n / n;
+        into->m2[m] += from->m2[m] + delta[m] * delta[m] * weight;
+    }
+    for (int p = 0; p < CORRELATION_PAIRS; p++)
+        into->comoment[p] += from->comoment[p] +
+                             delta[pair_metrics[p][0]] * delta[pair_metrics[p][1]] * weight;
+    into->n = n;
+}
+
+// combine reports of disjoint ranges (threads, segments, files); lag pairs
+// that would span the two ranges are not recreated
+void merge_correlation_report(CorrelationReport *into, CorrelationReport *from)
+{
+    merge_metric_moments(&into->moments, &from->moments);
+    merge_lag_moments(&into->lag, &from->lag);
+    into->days += from->days;
+}
+
+// Pearson correlation of pair 0 (temp-humidity), 1 (humidity-wind), 2 (temp-wind)
+double moments_correlation(MetricMoments *moments, int pair)
+{
+    return pearson(moments->m2[pair_metrics[pair][0]], moments->m2[pair_metrics[pair][1]],
+                   moments->comoment[pair]);
+}
+
+double lag_correlation(LagMoments *lag)
+{
+    return pearson(lag->m2[0], lag->m2[1], lag->comoment);
+}
+
+// report over the days from..to (YYYY-MM-DD, NULL = open end) of
+// weather_system, split across threads; weather_system is sorted by date
+// and repeated dates are dropped first (the last copy is kept)
+// returns 0 on success
+int correlation_report(WeatherSystem *weather_system, const char *from, const char *to,
+                       int lag_hours, int threads, CorrelationReport *report)
+{
+    init_correlation_report(report, lag_hours);
+    if (!weather_system ||
+        sort_daily_logs(weather_system->logs, weather_system->days_logged) != 0)
+        return -1;
+    weather_system->days_logged = dedupe_daily_logs(weather_system->logs,
+                                                    weather_system->days_logged);
+
+    DailyWeatherLog *logs = weather_system->logs;
+    int range_first = 0, range_last = weather_system->days_logged;
+    while (from && range_first < range_last && strcmp(logs[range_first].date_str, from) < 0)
+        range_first++;
+    while (to && range_last > range_first && strcmp(logs[range_last - 1].date_str, to) > 0)
+        range_last--;
+
+    int days = range_last - range_first;
+    long *day_numbers = (long *)malloc(sizeof(long) * (weather_system->days_logged + 1));
+    if (!day_numbers)
+    {
+        printf("ERROR: Failed to allocate day numbers for %d days.\n", days);
+        return -1;
+    }
+    for (int d = range_first; d < range_last; d++)
+        day_numbers[d] = date_day_number(logs[d].date_str);
+
+    if (threads < 1)
+        threads = 1;
+    if (threads > MAX_SCAN_THREADS)
+        threads = MAX_SCAN_THREADS;
+    if (threads > days)
+        threads = days > 0 ? days : 1;
+
+    pthread_t workers[MAX_SCAN_THREADS];
+    int started[MAX_SCAN_THREADS];
+    CorrelationTask tasks[MAX_SCAN_THREADS];
+    for (int t = 0; t < threads; t++)
+    {
+        tasks[t].weather_system = weather_system;
+        tasks[t].day_numbers = day_numbers;
+        tasks[t].range_first = range_first;
+        tasks[t].range_last = range_last;
+        tasks[t].first_day = range_first + (int)((long)days * t / threads);
+        tasks[t].last_day = range_first + (int)((long)days * (t + 1) / threads);
+        init_correlation_report(&tasks[t].report, report->lag_hours);
+        started[t] = pthread_create(&workers[t], NULL, correlation_worker, &tasks[t]) == 0;
+        if (!started[t])
+            correlation_worker(&tasks[t]); // run inline if no thread available
+    }
+
+    // threads own disjoint days and every lag pair: merging loses nothing
+    for (int t = 0; t < threads; t++)
+    {
+        if (started[t])
+            pthread_join(workers[t], NULL);
+        merge_correlation_report(report, &tasks[t].report);
+    }
+    report->days = days;
+    free(day_numbers);
+    return 0;
+}
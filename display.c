@@ -39,6 +39,14 @@
  * - print_hour_entry(temperatureLog*)
  * - print_daily_log(DailyWeatherLog*)
  * - print_system_summary(WeatherSystem*)
+ * - print_daily_summary(DailyWeatherLog*)
+ * - print_anomaly_event(AnomalyEvent*, void*)
+ * - print_query_response(QueryResponse*)
+ * - print_weather_snapshot(WeatherSnapshot*)
+ * - print_load_report(LoadGenReport*)
+ * - print_day_moments(const char *date_str, MetricMoments*)
+ * - print_correlation_report(CorrelationReport*)
+ * - print_extreme_reading(WeatherSystem*, ExtremeReading*, rank, WeatherMetric)
  */
 
 // --------------------------------------------------
@@ -46,6 +54,7 @@
 // --------------------------------------------------
 #include <stdio.h>  // for printf()
 #include <string.h> // for strcmp()
+#include <math.h>   // for sqrt()
 
 #include "weather_logger.h"
 
@@ -97,3 +106,141 @@ void print_system_summary(WeatherSystem *weather_system)
         print_daily_log(&weather_system->logs[i]);
     }
 }
+
+// prints one line of daily statistics (for query results)
+void print_daily_summary(DailyWeatherLog *daily_log)
+{
+    printf(" %s\t| Avg %.1f C\t| Min %.1f C\t| Max %.1f C\n",
+           daily_log->date_str,
+           daily_log->avg_temperature,
+           daily_log->min_temperature,
+           daily_log->max_temperature);
+}
+
+// prints one anomaly (usable as an AnomalyCallback)
+void print_anomaly_event(AnomalyEvent *event, void *context)
+{
+    static const char *names[] = {"Temperature", "Humidity", "Wind"};
+    static const char *units[] = {"C", "%", "m/s"};
+    (void)context;
+
+    printf("ANOMALY %s %02d:00 | %s %.1f %s\t| zshort %+.1f | zlong %+.1f | zEWMA %+.1f\n",
+           event->date_str, event->hour,
+           names[event->metric], event->value, units[event->metric],
+           event->z_short, event->z_long, event->z_ewma);
+}
+
+// prints the answer of the query server
+void print_query_response(QueryResponse *response)
+{
+    if (response->status == QUERY_STATUS_NOT_FOUND)
+    {
+        printf("No matching days.\n");
+        return;
+    }
+    if (response->status != QUERY_STATUS_OK)
+    {
+        printf("Query rejected by server (status %u).\n", response->status);
+        return;
+    }
+
+    printf("Date: %s (%u days)\n", response->date_str, response->days);
+    printf("Average Temperature: %.1f °C\n", response->avg_temperature);
+    printf("Min Temperature: %.1f °C\n", response->min_temperature);
+    printf("Max Temperature: %.1f °C\n", response->max_temperature);
+    printf("Average Humidity: %.1f %%\n", response->avg_humidity);
+    printf("Average Wind: %.1f m/s\n", response->avg_wind_speed);
+}
+
+// prints a shared-memory snapshot (latest reading + current day stats)
+void print_weather_snapshot(WeatherSnapshot *snapshot)
+{
+    if (snapshot->hours == 0)
+    {
+        printf("No readings published yet.\n");
+        return;
+    }
+
+    printf("Date: %s (%u hours, %llu readings published)\n", snapshot->date_str,
+           snapshot->hours, (unsigned long long)snapshot->published);
+    printf("Latest reading:\n");
+    print_hour_entry(&snapshot->latest);
+    printf("Average Temperature so far: %.1f °C\n", snapshot->avg_temperature);
+    printf("Min Temperature so far: %.1f °C\n", snapshot->min_temperature);
+    printf("Max Temperature so far: %.1f °C\n", snapshot->max_temperature);
+}
+
+// prints throughput and latency percentiles of a load generator run
+void print_load_report(LoadGenReport *report)
+{
+    double seconds = report->elapsed_ms / 1000.0;
+    LatencyHistogram *latency = &report->latency;
+
+    printf("Load: %d stations, %ld readings, %ld days in %.2f s\n",
+           report->stations, report->readings, report->days, seconds);
+    if (report->target_rate > 0.0)
+        printf("Throughput: %.0f readings/s (target %.0f)\n",
+               seconds > 0.0 ? report->readings / seconds : 0.0, report->target_rate);
+    else
+        printf("Throughput: %.0f readings/s (unthrottled)\n",
+               seconds > 0.0 ? report->readings / seconds : 0.0);
+    printf("WAL: %lu fsyncs (%.1f readings per fsync)\n", report->syncs,
+           report->syncs ? (double)report->readings / report->syncs : 0.0);
+    printf("Latency ms: p50 %.3f | p99 %.3f | p99.9 %.3f | max %.3f\n",
+           latency_histogram_percentile(latency, 50.0),
+           latency_histogram_percentile(latency, 99.0),
+           latency_histogram_percentile(latency, 99.9),
+           latency->max_us / 1000.0);
+}
+
+// prints one day of a correlation report: mean ± std dev, then r per pair
+void print_day_moments(const char *date_str, MetricMoments *moments)
+{
+    double n = moments->n > 1.0 ? moments->n - 1.0 : 1.0;
+    printf("%s | T %.1f ± %.1f | H %.1f ± %.1f | W %.1f ± %.1f"
+           " | r(T,H) %+.2f | r(H,W) %+.2f | r(T,W) %+.2f\n",
+           date_str,
+           moments->mean[0], sqrt(moments->m2[0] / n),
+           moments->mean[1], sqrt(moments->m2[1] / n),
+           moments->mean[2], sqrt(moments->m2[2] / n),
+           moments_correlation(moments, 0), moments_correlation(moments, 1),
+           moments_correlation(moments, 2));
+}
+
+// prints the range statistics of a correlation report
+void print_correlation_report(CorrelationReport *report)
+{
+    static const char *names[] = {"Temperature", "Humidity", "Wind"};
+    static const char *pairs[] = {"Temperature-Humidity", "Humidity-Wind", "Temperature-Wind"};
+    MetricMoments *moments = &report->moments;
+    double n = moments->n > 1.0 ? moments->n - 1.0 : 1.0;
+
+    printf("Readings: %.0f\n", moments->n);
+    printf("%-22s %10s %10s\n", "Metric", "Mean", "Variance");
+    for (int m = 0; m < ANOMALY_METRICS; m++)
+        printf("%-22s %10.3f %10.3f\n", names[m], moments->mean[m], moments->m2[m] / n);
+
+    printf("%-22s %10s %10s\n", "Pair", "Covariance", "Pearson r");
+    for (int p = 0; p < CORRELATION_PAIRS; p++)
+        printf("%-22s %10.3f %+10.4f\n", pairs[p], moments->comoment[p] / n,
+               moments_correlation(moments, p));
+
+    printf("Temperature autocorrelation at lag %dh: %+.4f (%.0f pairs)\n",
+           report->lag_hours, lag_correlation(&report->lag), report->lag.n);
+}
+
+// prints one ranked result of a top-K query
+void print_extreme_reading(WeatherSystem *weather_system, ExtremeReading *reading,
+                           int rank, WeatherMetric metric)
+{
+    static const char *names[] = {"Temperature", "Humidity", "Wind", "Average Temperature"};
+    static const char *units[] = {"°C", "%", "m/s", "°C"};
+    const char *date_str = weather_system->logs[reading->day].date_str;
+
+    if (reading->hour < 0)
+        printf("%4d. %s\t| %s %.1f %s\n", rank, date_str,
+               names[metric], reading->value, units[metric]);
+    else
+        printf("%4d. %s %02d:00\t| %s %.1f %s\n", rank, date_str, reading->hour,
+               names[metric], reading->value, units[metric]);
+}
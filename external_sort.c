@@ -0,0 +1,374 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// External Sort Module
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Order the days of a text log by date with bounded memory:
+ *   at most run_days days are held at once.
+ * - Sorted runs are spilled to temporary binary files and combined with
+ *   a k-way heap merge.
+ * - Runs are merged level by level: SORT_MAX_FANIN runs of level k become
+ *   one run of level k + 1, so each day is rewritten once per level
+ *   (O(n log_F n) I/O) and at most SORT_MAX_FANIN runs per level are open.
+ * - Repeated dates are dropped; the copy that arrived last wins.
+ *
+ * Every run of level k is older than every run of level k - 1, and runs of
+ * one level are kept in arrival order, so "higher run number = newer"
+ * holds whenever runs are merged oldest (highest level) first.
+ *
+ * Functions:
+ * - external_sort_logs(const char *infile, const char *outfile, int run_days, SortStats*)
+ */
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#include <stdio.h>  // for printf(), tmpfile(), fread(), fwrite()
+#include <stdlib.h> // for malloc(), free()
+#include <string.h> // for strcmp()
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal types and helpers
+// --------------------------------------------------
+
+// head of one sorted run during a merge
+typedef struct SortRunCursor
+{
+    FILE *fptr;              // Run file, positioned after current
+    DailyWeatherLog current; // Smallest unmerged day of the run
+    int run;                 // Run number: higher arrived later
+} SortRunCursor;
+
+// heap order: earlier date first; for equal dates the newest run first
+static int cursor_before(SortRunCursor *a, SortRunCursor *b)
+{
+    int cmp = strcmp(a->current.date_str, b->current.date_str);
+    return cmp < 0 || (cmp == 0 && a->run > b->run);
+}
+
+static void heap_sift_down(SortRunCursor **heap, int size, int i)
+{
+    for (;;)
+    {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < size && cursor_before(heap[left], heap[smallest]))
+            smallest = left;
+        if (right < size && cursor_before(heap[right], heap[smallest]))
+            smallest = right;
+        if (smallest == i)
+            return;
+        SortRunCursor *tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+// sort one in-memory run, keep the last copy of each date, spill it
+static FILE *spill_run(DailyWeatherLog *days, int count, SortStats *stats)
+{
+    // stable sort: among equal dates the last one is the newest
+    if (sort_daily_logs(days, count) != 0)
+        return NULL;
+
+    FILE *fptr = tmpfile();
+    if (fptr == NULL)
+    {
+        printf("ERROR: Could not create a temporary run file.\n");
+        return NULL;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (i + 1 < count && strcmp(days[i].date_str, days[i + 1].date_str) == 0)
+        {
+            stats->duplicates++;
+            continue;
+        }
+        if (fwrite(&days[i], sizeof(DailyWeatherLog), 1, fptr) != 1)
+        {
+            printf("ERROR: Could not write a temporary run file.\n");
+            fclose(fptr);
+            return NULL;
+        }
+    }
+
+    rewind(fptr);
+    stats->runs++;
+    return fptr;
+}
+
+// k-way merge of runs[0..count-1] (oldest first); every unique date is
+// passed to either out_run (binary) or out_text (text log), or only
+// counted if both are NULL
+// returns number of days emitted, or -1 on error
+static long merge_runs(FILE **runs, int count, FILE *out_run, FILE *out_text,
+                       SortStats *stats)
+{
+    SortRunCursor *cursors = (SortRunCursor *)malloc(sizeof(SortRunCursor) * count);
+    SortRunCursor **heap = (SortRunCursor **)malloc(sizeof(SortRunCursor *) * count);
+    if (!cursors || !heap)
+    {
+        printf("ERROR: Failed to allocate merge of %d runs.\n", count);
+        free(cursors);
+        free(heap);
+        return -1;
+    }
+
+    int size = 0;
+    for (int r = 0; r < count; r++)
+    {
+        cursors[r].fptr = runs[r];
+        cursors[r].run = r;
+        if (fread(&cursors[r].current, sizeof(DailyWeatherLog), 1, runs[r]) == 1)
+            heap[size++] = &cursors[r];
+    }
+    for (int i = size / 2 - 1; i >= 0; i--)
+        heap_sift_down(heap, size, i);
+
+    long emitted = 0;
+    char last_date[DATE_LEN] = "";
+    while (size > 0)
+    {
+        SortRunCursor *top = heap[0];
+
+        // first copy of a date popped is the newest one: older copies follow
+        if (emitted > 0 && strcmp(top->current.date_str, last_date) == 0)
+            stats->duplicates++;
+        else
+        {
+            int ok = 1;
+            if (out_run)
+                ok = fwrite(&top->current, sizeof(DailyWeatherLog), 1, out_run) == 1;
+            else if (out_text)
+                ok = (write_daily_log(out_text, &top->current), !ferror(out_text));
+            if (!ok)
+            {
+                printf("ERROR: Could not write merged days.\n");
+                emitted = -1;
+                break;
+            }
+            snprintf(last_date, DATE_LEN, "%s", top->current.date_str);
+            emitted++;
+        }
+
+        if (fread(&top->current, sizeof(DailyWeatherLog), 1, top->fptr) != 1)
+            heap[0] = heap[--size];
+        heap_sift_down(heap, size, 0);
+    }
+
+    free(cursors);
+    free(heap);
+    return emitted;
+}
+
+// merge all runs of one level into a single temp run
+static FILE *merge_level(FILE **runs, int *count, SortStats *stats)
+{
+    FILE *merged = tmpfile();
+    int status = merged != NULL && merge_runs(runs, *count, merged, NULL, stats) >= 0 ? 0 : -1;
+    for (int r = 0; r < *count; r++)
+        fclose(runs[r]);
+    *count = 0;
+
+    if (status != 0)
+    {
+        printf("ERROR: Could not merge sorted runs.\n");
+        if (merged != NULL)
+            fclose(merged);
+        return NULL;
+    }
+    rewind(merged);
+    return merged;
+}
+
+// add a run as the newest of `level`; a full level is merged into one run
+// of the next level (like carrying in a base-SORT_MAX_FANIN counter)
+static int push_run(FILE *levels[][SORT_MAX_FANIN], int *counts, int level, FILE *run,
+                    SortStats *stats)
+{
+    while (run != NULL)
+    {
+        if (level >= SORT_MAX_LEVELS)
+        {
+            printf("ERROR: Too many sorted runs (more than %d levels).\n", SORT_MAX_LEVELS);
+            fclose(run);
+            return -1;
+        }
+        levels[level][counts[level]++] = run;
+        if (counts[level] < SORT_MAX_FANIN)
+            return 0;
+
+        run = merge_level(levels[level], &counts[level], stats);
+        if (run == NULL)
+            return -1;
+        level++;
+        if (level > stats->passes)
+            stats->passes = level;
+    }
+    return -1;
+}
+
+// --------------------------------------------------
+// External sort function
+// --------------------------------------------------
+
+// compact infile into outfile: days in date order, one copy per date
+// returns 0 on success
+int external_sort_logs(const char *infile, const char *outfile, int run_days,
+                       SortStats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (run_days < 1)
+        run_days = SORT_RUN_DAYS;
+
+    if (strcmp(infile, outfile) == 0)
+    {
+        printf("ERROR: Input and output must be different files.\n");
+        return -1;
+    }
+
+    FILE *in;
+    FOPEN(in, infile, "r");
+    if (in == NULL)
+    {
+        printf("ERROR: Could not open file '%s' for reading.\n", infile);
+        return -1;
+    }
+
+    DailyWeatherLog *days = (DailyWeatherLog *)malloc(sizeof(DailyWeatherLog) * run_days);
+    FILE *(*levels)[SORT_MAX_FANIN] =
+        (FILE *(*)[SORT_MAX_FANIN])malloc(sizeof(FILE *) * SORT_MAX_LEVELS * SORT_MAX_FANIN);
+    FILE **runs = (FILE **)malloc(sizeof(FILE *) * SORT_MAX_LEVELS * SORT_MAX_FANIN);
+    int counts[SORT_MAX_LEVELS] = {0};
+    if (!days || !levels || !runs)
+    {
+        printf("ERROR: Failed to allocate a run of %d days.\n", run_days);
+        free(days);
+        free(levels);
+        free(runs);
+        fclose(in);
+        return -1;
+    }
+
+    // phase 1: sorted runs of at most run_days days, merged level by level
+    int status = 0;
+    int count = 0;
+    int read_status;
+    while (status == 0 && (read_status = read_daily_log(in, &days[count])) != 0)
+    {
+        if (read_status < 0)
+        {
+            printf("WARNING: Skipping malformed day in '%s'.\n", infile);
+            continue;
+        }
+        stats->days_in++;
+        if (++count < run_days)
+            continue;
+
+        FILE *run = spill_run(days, count, stats);
+        status = run != NULL ? push_run(levels, counts, 0, run, stats) : -1;
+        count = 0;
+    }
+    fclose(in);
+
+    if (status == 0 && count > 0)
+    {
+        FILE *run = spill_run(days, count, stats);
+        status = run != NULL ? push_run(levels, counts, 0, run, stats) : -1;
+    }
+    free(days);
+
+    // the last merge takes at most SORT_MAX_FANIN runs: fold the lowest
+    // (newest) levels into the next one until the rest fit
+    for (int l = 0; status == 0 && l + 1 < SORT_MAX_LEVELS; l++)
+    {
+        int nruns = 0;
+        for (int k = 0; k < SORT_MAX_LEVELS; k++)
+            nruns += counts[k];
+        if (nruns <= SORT_MAX_FANIN)
+            break;
+        if (counts[l] == 0)
+            continue;
+
+        FILE *run = merge_level(levels[l], &counts[l], stats);
+        status = run != NULL ? push_run(levels, counts, l + 1, run, stats) : -1;
+        if (status == 0 && l + 1 > stats->passes)
+            stats->passes = l + 1;
+    }
+
+    // oldest first: highest level down to level 0, arrival order inside
+    int nruns = 0;
+    for (int l = SORT_MAX_LEVELS - 1; l >= 0; l--)
+        for (int r = 0; r < counts[l]; r++)
+            runs[nruns++] = levels[l][r];
+
+    // phase 2: count the unique days, then merge straight into the text log
+    FILE *out = NULL;
+    if (status == 0)
+        FOPEN(out, outfile, "w");
+    if (status == 0 && out == NULL)
+    {
+        printf("ERROR: Could not open file '%s' for writing.\n", outfile);
+        status = -1;
+    }
+
+    if (status == 0)
+    {
+        SortStats counting;
+        memset(&counting, 0, sizeof(counting));
+        long unique = merge_runs(runs, nruns, NULL, NULL, &counting);
+        for (int r = 0; r < nruns; r++)
+            rewind(runs[r]);
+
+        fprintf(out, "WEATHER SYSTEM LOG EXPORT\n");
+        fprintf(out, "Days Recorded: %ld\n\n", unique);
+
+        long emitted = unique < 0 ? -1 : merge_runs(runs, nruns, NULL, out, stats);
+        stats->passes++;
+        if (emitted < 0)
+            status = -1;
+        else
+            stats->days_out = emitted;
+        if (fclose(out) != 0)
+            status = -1;
+    }
+
+    for (int r = 0; r < nruns; r++)
+        fclose(runs[r]);
+    free(levels);
+    free(runs);
+    return status;
+}
@@ -39,11 +39,15 @@
  * - save_daily_log_to_file(DailyWeatherLog*, const char* filename)
  * - save_system_logs(WeatherSystem*, const char *filename)
  * - append_summary(DailyWeatherLog*, const char *filename)
+ * - write_daily_log(FILE*, DailyWeatherLog*)
+ * - read_daily_log(FILE*, DailyWeatherLog*)
+ * - load_system_logs(WeatherSystem*, const char *filename)
  */
 // --------------------------------------------------
 // header files
 // --------------------------------------------------
-#include <stdio.h> // for printf()
+#include <stdio.h>  // for printf()
+#include <string.h> // for strncmp(), memset()
 // #include <stdlib.h> // for rand(), srand(), RAND_MAX macro
 
 #include "weather_logger.h"
@@ -64,23 +68,7 @@ void save_daily_log_to_file(DailyWeatherLog *daily_log, const char *filename)
         return;
     }
 
-    fprintf(fptr, "==============================================\n");
-    fprintf(fptr, "Date: %s\n", daily_log->date_str); // 2025-12-06
-    fprintf(fptr, "--------------------------------------\n");
-    fprintf(fptr, " Hour\t| Temperature(C)\t| Humidity(%%)\t| Wind(m/s)\n");
-    fprintf(fptr, "--------------------------------------\n");
-    for (int i = 0; i < DAILY_LOG; i++)
-    {
-        TemperatureLog *t = &daily_log->entries[i];
-        fprintf(fptr, " %02d\t| %.1f C\t| %.1f %%\t| %.1f m/s\n",
-                t->hour, t->temperature, t->humidity, t->wind_speed);
-    }
-    fprintf(fptr, "--------------------------------------\n");
-    fprintf(fptr, "Daily Average Temperature: %.1f °C\n", daily_log->avg_temperature); // 19.1
-    fprintf(fptr, "Min Temperature: %.1f °C\n", daily_log->min_temperature);           // 15.1
-    fprintf(fptr, "Max Temperature: %.1f °C\n", daily_log->max_temperature);           // 23.8
-    fprintf(fptr, "==============================================\n");
-
+    write_daily_log(fptr, daily_log);
     fclose(fptr);
 }
 
@@ -124,3 +112,112 @@ void append_summary(DailyWeatherLog *daily_log, const char *filename)
 
     fclose(fptr);
 }
+
+// write one day in the text log format to an open stream
+void write_daily_log(FILE *fptr, DailyWeatherLog *daily_log)
+{
+    fprintf(fptr, "==============================================\n");
+    fprintf(fptr, "Date: %s\n", daily_log->date_str); // 2025-12-06
+    fprintf(fptr, "--------------------------------------\n");
+    fprintf(fptr, " Hour\t| Temperature(C)\t| Humidity(%%)\t| Wind(m/s)\n");
+    fprintf(fptr, "--------------------------------------\n");
+    for (int i = 0; i < DAILY_LOG; i++)
+    {
+        TemperatureLog *t = &daily_log->entries[i];
+        fprintf(fptr, " %02d\t| %.1f C\t| %.1f %%\t| %.1f m/s\n",
+                t->hour, t->temperature, t->humidity, t->wind_speed);
+    }
+    fprintf(fptr, "--------------------------------------\n");
+    fprintf(fptr, "Daily Average Temperature: %.1f °C\n", daily_log->avg_temperature); // 19.1
+    fprintf(fptr, "Min Temperature: %.1f °C\n", daily_log->min_temperature);           // 15.1
+    fprintf(fptr, "Max Temperature: %.1f °C\n", daily_log->max_temperature);           // 23.8
+    fprintf(fptr, "==============================================\n");
+}
+
+// read the next day written by write_daily_log(); other lines (export
+// headers, SUMMARY blocks) are skipped. A day cut short ends at the next
+// opening rule or "Date: " line, which is left for the following call.
+// returns 1 if a day was read, 0 at end of file, -1 on a malformed day
+int read_daily_log(FILE *fptr, DailyWeatherLog *daily_log)
+{
+    char line[128];
+
+    // seek the next "Date: " line
+    for (;;)
+    {
+        if (fgets(line, sizeof(line), fptr) == NULL)
+            return 0;
+        if (strncmp(line, "Date: ", 6) == 0)
+            break;
+    }
+
+    memset(daily_log, 0, sizeof(*daily_log));
+    if (sscanf(line + 6, "%15s", daily_log->date_str) != 1)
+        return -1;
+
+    int hours = 0;
+    int stats = 0;
+    long line_start = ftell(fptr);
+    while (stats < 3 && fgets(line, sizeof(line), fptr) != NULL)
+    {
+        // the next day starts before this one finished: it was truncated
+        if (strncmp(line, "Date: ", 6) == 0)
+        {
+            fseek(fptr, line_start, SEEK_SET); // re-read by the next call
+            return -1;
+        }
+        if (strncmp(line, "=====", 5) == 0)
+            return -1;
+
+        TemperatureLog t;
+        if (hours < DAILY_LOG &&
+            sscanf(line, " %d | %f C | %f %% | %f m/s",
+                   &t.hour, &t.temperature, &t.humidity, &t.wind_speed) == 4)
+        {
+            if (t.hour < 0 || t.hour >= DAILY_LOG)
+                return -1;
+            daily_log->entries[t.hour] = t;
+            hours++;
+        }
+        else if (sscanf(line, "Daily Average Temperature: %f", &daily_log->avg_temperature) == 1 ||
+                 sscanf(line, "Min Temperature: %f", &daily_log->min_temperature) == 1 ||
+                 sscanf(line, "Max Temperature: %f", &daily_log->max_temperature) == 1)
+            stats++;
+        line_start = ftell(fptr);
+    }
+
+    return (hours == DAILY_LOG && stats == 3) ? 1 : -1;
+}
+
+// load every day of a text log into weather_system (grows storage as needed)
+// returns number of days loaded, or -1 if the file could not be read
+int load_system_logs(WeatherSystem *weather_system, const char *filename)
+{
+    FILE *fptr;
+    FOPEN(fptr, filename, "r");
+    if (fptr == NULL)
+    {
+        printf("ERROR: Could not open file '%s' for reading.\n", filename);
+        return -1;
+    }
+
+    int loaded = 0;
+    int status;
+    DailyWeatherLog daily;
+    while ((status = read_daily_log(fptr, &daily)) != 0)
+    {
+        if (status < 0)
+        {
+            printf("WARNING: Skipping malformed day in '%s'.\n", filename);
+            continue;
+        }
+        if (weather_system->days_logged >= weather_system->max_days &&
+            reserve_weather_system(weather_system, weather_system->max_days * 2 + 1) != 0)
+            break;
+        add_daily_log(weather_system, &daily);
+        loaded++;
+    }
+
+    fclose(fptr);
+    return loaded;
+}
@@ -0,0 +1,321 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Load Generator Module
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Simulate `stations` stations with the simulation model and replay
+ *   their hourly readings into the ingestion path (WAL group commit,
+ *   in-memory days, checkpoints to the text log) at a fixed rate.
+ * - Measure every reading from its *intended* send time until it is
+ *   durable, so stalls are charged to all readings they delay
+ *   (no coordinated omission).
+ * - Record latencies in an HDR-style log-linear histogram.
+ *
+ * Stations advance in lockstep (reading i belongs to station i % stations),
+ * so all of them reach a day boundary together and the shared WAL can be
+ * checkpointed there.
+ *
+ * The WAL is a scratch file: its records carry no station id, so the
+ * interleaved readings cannot be replayed by --wal. A WAL that already
+ * holds data is refused, and the WAL is removed after a successful run.
+ *
+ * Functions:
+ * - latency_histogram_reset(LatencyHistogram*)
+ * - latency_histogram_record(LatencyHistogram*, double ms)
+ * - latency_histogram_percentile(LatencyHistogram*, double percentile)
+ * - run_load_generator(walfile, outfile, stations, rate, seconds, LoadGenReport*)
+ */
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#include <stdio.h>  // for printf(), remove()
+#include <stdlib.h> // for malloc(), free()
+#include <string.h> // for memset()
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal helpers
+// --------------------------------------------------
+
+#define LOADGEN_SPIN_MS 0.1 // Busy-wait below this, nanosleep() is too coarse
+
+// 1 if the file exists and is not empty
+static int file_has_data(const char *filename)
+{
+    FILE *fptr;
+    FOPEN(fptr, filename, "rb");
+    if (fptr == NULL)
+        return 0;
+    fseek(fptr, 0, SEEK_END);
+    long size = ftell(fptr);
+    fclose(fptr);
+    return size > 0;
+}
+
+// bucket of a value in microseconds
+static int latency_bucket(uint64_t us)
+{
+    if (us < LATENCY_SUB_BUCKETS)
+        return (int)us;
+
+    int msb = LATENCY_SUB_BITS;
+    while ((us >> (msb + 1)) != 0)
+        msb++;
+    int shift = msb - LATENCY_SUB_BITS;
+    int top = (int)(us >> shift); // LATENCY_SUB_BUCKETS .. 2 * LATENCY_SUB_BUCKETS - 1
+    return (shift + 1) * LATENCY_SUB_BUCKETS + (top - LATENCY_SUB_BUCKETS);
+}
+
+// largest value in microseconds that falls into a bucket
+static uint64_t latency_bucket_high(int bucket)
+{
+    if (bucket < LATENCY_SUB_BUCKETS)
+        return (uint64_t)bucket;
+
+    int shift = bucket / LATENCY_SUB_BUCKETS - 1;
+    uint64_t top = LATENCY_SUB_BUCKETS + bucket % LATENCY_SUB_BUCKETS;
+    return ((top + 1) << shift) - 1;
+}
+
+// record readings up to the WAL's durable LSN; intended[] holds the
+// intended send time of every LSN not yet acknowledged
+static void acknowledge_durable(WriteAheadLog *wal, uint64_t *acked,
+                                const double *intended, LatencyHistogram *latency)
+{
+    if (*acked >= wal->durable_lsn)
+        return;
+
+    double now = get_monotonic_ms();
+    while (*acked < wal->durable_lsn)
+    {
+        (*acked)++;
+        latency_histogram_record(latency, now - intended[*acked % WAL_GROUP_RECORDS]);
+    }
+}
+
+// wait until `until` (monotonic ms), committing WAL groups whose window
+// expires in the meantime
+static void wait_until(WriteAheadLog *wal, uint64_t *acked, const double *intended,
+                       LatencyHistogram *latency, double until)
+{
+    for (;;)
+    {
+        double now = get_monotonic_ms();
+        double wait = until - now;
+        if (wal->pending_count > 0)
+        {
+            double due = wal->first_pending_ms + WAL_GROUP_WINDOW_MS - now;
+            if (due <= 0.0)
+            {
+                wal_commit_expired(wal);
+                acknowledge_durable(wal, acked, intended, latency);
+                continue;
+            }
+            if (due < wait)
+                wait = due;
+        }
+        if (wait <= 0.0)
+            return;
+        if (wait >= LOADGEN_SPIN_MS)
+            sleep_ms(wait - LOADGEN_SPIN_MS / 2);
+    }
+}
+
+// --------------------------------------------------
+// histogram functions
+// --------------------------------------------------
+
+void latency_histogram_reset(LatencyHistogram *histogram)
+{
+    memset(histogram, 0, sizeof(*histogram));
+}
+
+// add one latency sample (milliseconds, stored rounded up to microseconds)
+void latency_histogram_record(LatencyHistogram *histogram, double ms)
+{
+    uint64_t limit = ((uint64_t)1 << LATENCY_MAX_BITS) - 1;
+    double us = ms * 1000.0;
+    uint64_t value = us <= 0.0 ? 0 : (uint64_t)us + 1;
+    if (value > limit)
+        value = limit;
+
+    histogram->counts[latency_bucket(value)]++;
+    histogram->total++;
+    if (value > histogram->max_us)
+        histogram->max_us = value;
+}
+
+// value (ms) below or at which `percentile` percent of the samples fall;
+// reported as the top of its bucket, so never below the true value
+double latency_histogram_percentile(LatencyHistogram *histogram, double percentile)
+{
+    if (histogram->total == 0)
+        return 0.0;
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * histogram->total + 0.999999);
+    if (rank < 1)
+        rank = 1;
+    if (rank >= histogram->total)
+        return histogram->max_us / 1000.0;
+
+    uint64_t seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++)
+    {
+        seen += histogram->counts[b];
+        if (seen >= rank)
+        {
+            uint64_t high = latency_bucket_high(b);
+            return (high < histogram->max_us ? high : histogram->max_us) / 1000.0;
+        }
+    }
+    return histogram->max_us / 1000.0;
+}
+
+// --------------------------------------------------
+// load generator function
+// --------------------------------------------------
+
+// replay simulated readings of `stations` stations into walfile at `rate`
+// readings/s (0 = as fast as possible) for `seconds`; finished days are
+// checkpointed to outfile (NULL discards them). walfile must be new or
+// empty and is removed after a successful run.
+// returns 0 on success
+int run_load_generator(const char *walfile, const char *outfile, int stations,
+                       double rate, double seconds, LoadGenReport *report)
+{
+    memset(report, 0, sizeof(*report));
+    report->stations = stations;
+    report->target_rate = rate;
+
+    // truncating someone's WAL at the first checkpoint would lose readings
+    if (file_has_data(walfile))
+    {
+        printf("ERROR: WAL '%s' is not empty. The load generator needs a new scratch WAL;\n"
+               "       replay it with --wal or delete it first.\n", walfile);
+        return -1;
+    }
+
+    DailyWeatherLog *days = (DailyWeatherLog *)malloc(sizeof(DailyWeatherLog) * stations);
+    if (!days)
+    {
+        printf("ERROR: Failed to allocate %d stations.\n", stations);
+        return -1;
+    }
+
+    WriteAheadLog wal;
+    if (wal_open(&wal, walfile) != 0)
+    {
+        free(days);
+        return -1;
+    }
+
+    // finished days between checkpoints, for every station
+    WeatherSystem weather_system;
+    init_weather_system(&weather_system, stations * WAL_CHECKPOINT_DAYS);
+
+    double intended[WAL_GROUP_RECORDS];
+    uint64_t acked = wal.durable_lsn;
+    long total = rate > 0.0 ? (long)(rate * seconds) : -1;
+    double interval_ms = rate > 0.0 ? 1000.0 / rate : 0.0;
+    int status = 0;
+    long rounds = 0;
+
+    double start = get_monotonic_ms();
+    for (long i = 0; total < 0 || i < total; i++)
+    {
+        // open loop: reading i is due at start + i * interval, however
+        // late the previous ones were
+        double due = start + i * interval_ms;
+        if (rate > 0.0)
+            wait_until(&wal, &acked, intended, &report->latency, due);
+        else if ((due = get_monotonic_ms()) - start >= seconds * 1000.0)
+            break;
+
+        int station = (int)(i % stations);
+        int hour = (int)(i / stations % DAILY_LOG);
+        DailyWeatherLog *daily = &days[station];
+        if (hour == 0)
+            init_daily_log(daily);
+        simulate_hour_record(daily, hour);
+
+        uint64_t lsn = wal_append(&wal, daily->date_str, &daily->entries[hour]);
+        if (lsn == 0)
+        {
+            status = -1; // the group commit failed
+            break;
+        }
+        intended[lsn % WAL_GROUP_RECORDS] = due;
+        report->readings++;
+
+        if (hour == DAILY_LOG - 1)
+        {
+            compute_statistics(daily);
+            add_daily_log(&weather_system, daily);
+            report->days++;
+        }
+        acknowledge_durable(&wal, &acked, intended, &report->latency);
+
+        // every station finished a day: checkpoint now and then
+        if (station == stations - 1 && hour == DAILY_LOG - 1 &&
+            ++rounds % WAL_CHECKPOINT_DAYS == 0)
+        {
+            if (wal_checkpoint(&wal, &weather_system, outfile) != 0)
+            {
+                status = -1;
+                break;
+            }
+            acknowledge_durable(&wal, &acked, intended, &report->latency);
+            weather_system.days_logged = 0;
+            wal.checkpoint_day = 0;
+        }
+    }
+
+    if (status == 0 && wal_commit(&wal) != 0)
+        status = -1;
+    acknowledge_durable(&wal, &acked, intended, &report->latency);
+    report->elapsed_ms = get_monotonic_ms() - start;
+
+    // days finished since the last checkpoint; partial days are dropped
+    // with the scratch WAL (their readings have no station id to resume by)
+    if (status == 0 && weather_system.days_logged > 0 &&
+        wal.pending_count == 0 && report->readings % (stations * DAILY_LOG) == 0)
+        status = wal_checkpoint(&wal, &weather_system, outfile);
+
+    report->syncs = wal.syncs;
+    wal_close(&wal);
+    if (status == 0)
+        remove(walfile);
+    destroy_weather_system(&weather_system);
+    free(days);
+    return status;
+}
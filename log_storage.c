@@ -40,6 +40,9 @@
  * - compute_statistics(DailyWeatherLog*)
  * - add_daily_log(WeatherSystem*, DailyWeatherLog*)
  * - init_weather_system(WeatherSystem*, max_days)
+ * - reserve_weather_system(WeatherSystem*, max_days)
+ * - sort_daily_logs(DailyWeatherLog*, count)
+ * - dedupe_daily_logs(DailyWeatherLog*, count)
  */
 
 // --------------------------------------------------
@@ -160,4 +163,96 @@ void destroy_weather_system(WeatherSystem *weather_system)
     weather_system->logs = NULL;
     weather_system->days_logged = 0;
     weather_system->max_days = 0;
-}
\ No newline at end of file
+}
+
+// --------------------------------------------------
+// Grow WeatherSystem storage to hold at least max_days
+// (used when days come from files instead of -n DAYS)
+// --------------------------------------------------
+int reserve_weather_system(WeatherSystem *weather_system, int max_days)
+{
+    if (!weather_system)
+        return -1;
+
+    if (max_days <= weather_system->max_days)
+        return 0;
+
+    DailyWeatherLog *logs = (DailyWeatherLog *)realloc(weather_system->logs,
+                                                       sizeof(DailyWeatherLog) * max_days);
+    if (!logs)
+    {
+        printf("ERROR: Failed to grow WeatherSystem storage to %d days.\n", max_days);
+        return -1;
+    }
+
+    weather_system->logs = logs;
+    weather_system->max_days = max_days;
+    return 0;
+}
+
+// --------------------------------------------------
+// Sort days chronologically (stable: equal dates keep arrival order)
+// --------------------------------------------------
+static void merge_daily_logs(DailyWeatherLog *logs, DailyWeatherLog *tmp,
+                             int lo, int mid, int hi)
+{
+    int i = lo, j = mid, k = lo;
+    while (i < mid && j < hi)
+    {
+        if (strcmp(logs[j].date_str, logs[i].date_str) < 0)
+            tmp[k++] = logs[j++];
+        else
+            tmp[k++] = logs[i++];
+    }
+    while (i < mid)
+        tmp[k++] = logs[i++];
+    while (j < hi)
+        tmp[k++] = logs[j++];
+    memcpy(&logs[lo], &tmp[lo], sizeof(DailyWeatherLog) * (hi - lo));
+}
+
+int sort_daily_logs(DailyWeatherLog *logs, int count)
+{
+    if (!logs || count < 2)
+        return 0;
+
+    DailyWeatherLog *tmp = (DailyWeatherLog *)malloc(sizeof(DailyWeatherLog) * count);
+    if (!tmp)
+    {
+        printf("ERROR: Failed to allocate sort buffer for %d days.\n", count);
+        return -1;
+    }
+
+    // bottom-up merge sort
+    for (int width = 1; width < count; width *= 2)
+    {
+        for (int lo = 0; lo < count - width; lo += 2 * width)
+        {
+            int mid = lo + width;
+            int hi = (lo + 2 * width < count) ? lo + 2 * width : count;
+            merge_daily_logs(logs, tmp, lo, mid, hi);
+        }
+    }
+
+    free(tmp);
+    return 0;
+}
+
+// on sorted days keep the last copy of each date (the newest, as --compact
+// does); returns the number of days left
+int dedupe_daily_logs(DailyWeatherLog *logs, int count)
+{
+    if (!logs)
+        return 0;
+
+    int kept = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (i + 1 < count && strcmp(logs[i].date_str, logs[i + 1].date_str) == 0)
+            continue;
+        if (kept != i)
+            logs[kept] = logs[i];
+        kept++;
+    }
+    return kept;
+}
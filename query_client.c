@@ -0,0 +1,291 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Query Client Module (Linux)
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Send one request to the query server and wait for its answer.
+ * - Load test: many concurrent connections from one process, each with
+ *   one request in flight, multiplexed with epoll; reports throughput
+ *   and latency percentiles.
+ *
+ * Functions:
+ * - query_client_request(const char *socket_path, QueryRequest*, QueryResponse*)
+ * - query_load_test(const char *socket_path, int clients, long requests)
+ */
+
+// epoll and Unix domain sockets: Linux only (see README build instructions)
+#if defined(__linux__)
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#define _POSIX_C_SOURCE 200809L // for sockets, epoll and setrlimit() in strict C modes
+
+#include <stdio.h>        // for printf()
+#include <stdlib.h>       // for malloc(), free(), qsort()
+#include <string.h>       // for memset()
+#include <errno.h>        // for errno, EAGAIN, EINTR
+#include <unistd.h>       // for read(), close()
+#include <fcntl.h>        // for fcntl(), O_NONBLOCK
+#include <sys/epoll.h>    // for epoll_create1(), epoll_ctl(), epoll_wait()
+#include <sys/resource.h> // for setrlimit()
+#include <sys/socket.h>   // for socket(), connect(), send()
+#include <sys/un.h>       // for sockaddr_un
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal types and helpers
+// --------------------------------------------------
+
+// one simulated client of the load test
+typedef struct LoadClient
+{
+    int fd;
+    double sent_ms;  // When the request in flight was sent
+    size_t received; // Bytes of the response read so far
+    QueryResponse response;
+} LoadClient;
+
+static int connect_server(const char *socket_path)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int send_all(int fd, const void *buffer, size_t len)
+{
+    const unsigned char *p = (const unsigned char *)buffer;
+    while (len > 0)
+    {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// request number i of the load test: rotate through the three operations
+static void load_request(QueryRequest *request, long i, const char *known_date)
+{
+    memset(request, 0, sizeof(*request));
+    request->id = (uint32_t)i;
+    request->op = QUERY_OP_LATEST + (uint32_t)(i % 3);
+    snprintf(request->from, DATE_LEN, "%s", request->op == QUERY_OP_DATE ? known_date : "2000-01-01");
+    snprintf(request->to, DATE_LEN, "%s", "2030-12-31");
+}
+
+// --------------------------------------------------
+// client functions
+// --------------------------------------------------
+
+// send one request and wait for the response; returns 0 on success
+int query_client_request(const char *socket_path, QueryRequest *request,
+                         QueryResponse *response)
+{
+    int fd = connect_server(socket_path);
+    if (fd < 0)
+    {
+        printf("ERROR: Could not connect to query server '%s'.\n", socket_path);
+        return -1;
+    }
+
+    size_t got = 0;
+    int status = send_all(fd, request, sizeof(*request));
+    while (status == 0 && got < sizeof(*response))
+    {
+        ssize_t n = read(fd, (unsigned char *)response + got, sizeof(*response) - got);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            status = -1;
+        else
+            got += (size_t)n;
+    }
+
+    close(fd);
+    if (status != 0)
+        printf("ERROR: Query server '%s' closed the connection.\n", socket_path);
+    return status;
+}
+
+// keep `clients` connections busy until `requests` answers arrived
+// returns 0 if every request was answered
+int query_load_test(const char *socket_path, int clients, long requests)
+{
+    // a date the server knows, for QUERY_OP_DATE requests
+    QueryRequest probe;
+    QueryResponse latest;
+    load_request(&probe, 0, "");
+    if (query_client_request(socket_path, &probe, &latest) != 0)
+        return -1;
+
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    LoadClient *pool = (LoadClient *)calloc(clients, sizeof(LoadClient));
+    double *latencies = (double *)malloc(sizeof(double) * requests);
+    int epfd = epoll_create1(0);
+    if (!pool || !latencies || epfd < 0)
+    {
+        printf("ERROR: Failed to set up %d load test clients.\n", clients);
+        free(pool);
+        free(latencies);
+        if (epfd >= 0)
+            close(epfd);
+        return -1;
+    }
+
+    int connected = 0;
+    for (; connected < clients; connected++)
+    {
+        LoadClient *client = &pool[connected];
+        client->fd = connect_server(socket_path);
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = client;
+        if (client->fd < 0 || fcntl(client->fd, F_SETFL, O_NONBLOCK) != 0 ||
+            epoll_ctl(epfd, EPOLL_CTL_ADD, client->fd, &ev) != 0)
+        {
+            printf("WARNING: Only %d of %d clients connected.\n", connected, clients);
+            if (client->fd >= 0)
+                close(client->fd);
+            break;
+        }
+    }
+
+    long sent = 0, done = 0, errors = 0, samples = 0;
+    double start_ms = get_monotonic_ms();
+
+    // one request in flight per client (closed loop)
+    for (int c = 0; c < connected && sent < requests; c++)
+    {
+        QueryRequest request;
+        load_request(&request, sent++, latest.date_str);
+        pool[c].sent_ms = get_monotonic_ms();
+        if (send_all(pool[c].fd, &request, sizeof(request)) != 0)
+            errors++, done++;
+    }
+
+    struct epoll_event events[QUERY_MAX_EVENTS];
+    while (done < sent && connected > 0)
+    {
+        int n = epoll_wait(epfd, events, QUERY_MAX_EVENTS, 5000);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            printf("ERROR: Load test timed out waiting for the server.\n");
+            break;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            LoadClient *client = (LoadClient *)events[i].data.ptr;
+            ssize_t r = read(client->fd, (unsigned char *)&client->response + client->received,
+                             sizeof(client->response) - client->received);
+            if (r <= 0)
+            {
+                if (r < 0 && (errno == EAGAIN || errno == EINTR))
+                    continue;
+                epoll_ctl(epfd, EPOLL_CTL_DEL, client->fd, NULL);
+                errors++, done++;
+                continue;
+            }
+            client->received += (size_t)r;
+            if (client->received < sizeof(client->response))
+                continue;
+
+            double now = get_monotonic_ms();
+            latencies[samples++] = now - client->sent_ms;
+            done++;
+            if (client->response.status != QUERY_STATUS_OK)
+                errors++;
+            client->received = 0;
+
+            if (sent < requests)
+            {
+                QueryRequest request;
+                load_request(&request, sent++, latest.date_str);
+                client->sent_ms = now;
+                if (send_all(client->fd, &request, sizeof(request)) != 0)
+                    errors++, done++;
+            }
+        }
+    }
+    double elapsed_ms = get_monotonic_ms() - start_ms;
+
+    qsort(latencies, (size_t)samples, sizeof(double), compare_double);
+
+    printf("Load test: %d clients, %ld requests, %ld errors\n", connected, done, errors);
+    if (samples > 0 && elapsed_ms > 0.0)
+    {
+        printf("Throughput: %.0f requests/s\n", done / (elapsed_ms / 1000.0));
+        printf("Latency ms: p50 %.3f | p99 %.3f | p99.9 %.3f | max %.3f\n",
+               latencies[samples / 2], latencies[samples * 99 / 100],
+               latencies[samples * 999 / 1000], latencies[samples - 1]);
+    }
+
+    for (int c = 0; c < connected; c++)
+        close(pool[c].fd);
+    close(epfd);
+    free(pool);
+    free(latencies);
+    return (errors == 0 && done == requests) ? 0 : -1;
+}
+
+#endif // __linux__
@@ -0,0 +1,512 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Query Server Module (Linux)
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Keep a WeatherSystem resident, sorted by date, with prefix sums and
+ *   min/max sparse tables so every query is O(log n).
+ * - Serve fixed-size QueryRequest / QueryResponse messages over a Unix
+ *   domain socket from a single epoll event loop (non-blocking sockets,
+ *   pipelined requests, per-connection buffers).
+ * - Stop cleanly on SIGINT / SIGTERM and remove the socket file.
+ * - Keep a spare descriptor: when the process runs out of descriptors a
+ *   pending client is accepted on it and closed, so the level-triggered
+ *   listener does not keep waking the loop.
+ * - Only replace a stale socket file: a regular file or a socket that a
+ *   running server still accepts on is left alone.
+ *
+ * Functions:
+ * - run_query_server(const char *socket_path, WeatherSystem*)
+ */
+
+// epoll and Unix domain sockets: Linux only (see README build instructions)
+#if defined(__linux__)
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#define _POSIX_C_SOURCE 200809L // for sigaction(), lstat(), S_ISSOCK() in strict C modes
+
+#include <stdio.h>        // for printf()
+#include <stdlib.h>       // for malloc(), free()
+#include <string.h>       // for memcpy(), memmove(), strcmp()
+#include <errno.h>        // for errno, EAGAIN, EINTR, EMFILE
+#include <signal.h>       // for sigaction()
+#include <unistd.h>       // for read(), write(), close(), unlink()
+#include <fcntl.h>        // for fcntl(), O_NONBLOCK
+#include <sys/epoll.h>    // for epoll_create1(), epoll_ctl(), epoll_wait()
+#include <sys/resource.h> // for setrlimit()
+#include <sys/socket.h>   // for socket(), bind(), listen(), accept()
+#include <sys/stat.h>     // for lstat(), S_ISSOCK()
+#include <sys/un.h>       // for sockaddr_un
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal types and helpers
+// --------------------------------------------------
+
+// read-only index over the resident days
+typedef struct QueryIndex
+{
+    DailyWeatherLog *days; // Sorted by date
+    int count;             // Days indexed
+    double *sum_avg;       // Prefix sums (count + 1 entries)
+    double *sum_humidity;  // of daily avg temperature, humidity, wind
+    double *sum_wind;
+    float *min_table;      // Sparse tables: levels rows of count entries,
+    float *max_table;      // row k holds min/max of days [i, i + 2^k)
+    int levels;            // Rows in the sparse tables
+} QueryIndex;
+
+typedef struct QueryConnection
+{
+    int fd;
+    size_t in_len;
+    size_t out_len;
+    unsigned char in[sizeof(QueryRequest) * QUERY_PIPELINE];
+    unsigned char out[sizeof(QueryResponse) * QUERY_PIPELINE];
+} QueryConnection;
+
+static volatile sig_atomic_t server_stop = 0;
+
+static void on_stop_signal(int signo)
+{
+    (void)signo;
+    server_stop = 1;
+}
+
+static void free_query_index(QueryIndex *index)
+{
+    free(index->sum_avg);
+    free(index->sum_humidity);
+    free(index->sum_wind);
+    free(index->min_table);
+    free(index->max_table);
+}
+
+static int build_query_index(QueryIndex *index, WeatherSystem *weather_system)
+{
+    memset(index, 0, sizeof(*index));
+    if (sort_daily_logs(weather_system->logs, weather_system->days_logged) != 0)
+        return -1;
+
+    int n = weather_system->days_logged;
+    index->days = weather_system->logs;
+    index->count = n;
+    index->levels = 1;
+    while ((1 << index->levels) <= n)
+        index->levels++;
+
+    index->sum_avg = (double *)malloc(sizeof(double) * (n + 1));
+    index->sum_humidity = (double *)malloc(sizeof(double) * (n + 1));
+    index->sum_wind = (double *)malloc(sizeof(double) * (n + 1));
+    index->min_table = (float *)malloc(sizeof(float) * index->levels * (n ? n : 1));
+    index->max_table = (float *)malloc(sizeof(float) * index->levels * (n ? n : 1));
+    if (!index->sum_avg || !index->sum_humidity || !index->sum_wind ||
+        !index->min_table || !index->max_table)
+    {
+        printf("ERROR: Failed to allocate query index for %d days.\n", n);
+        free_query_index(index);
+        return -1;
+    }
+
+    index->sum_avg[0] = index->sum_humidity[0] = index->sum_wind[0] = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        DailyWeatherLog *day = &index->days[i];
+        double humidity = 0.0, wind = 0.0;
+        for (int h = 0; h < DAILY_LOG; h++)
+        {
+            humidity += day->entries[h].humidity;
+            wind += day->entries[h].wind_speed;
+        }
+        index->sum_avg[i + 1] = index->sum_avg[i] + day->avg_temperature;
+        index->sum_humidity[i + 1] = index->sum_humidity[i] + humidity / DAILY_LOG;
+        index->sum_wind[i + 1] = index->sum_wind[i] + wind / DAILY_LOG;
+        index->min_table[i] = day->min_temperature;
+        index->max_table[i] = day->max_temperature;
+    }
+
+    for (int k = 1; k < index->levels; k++)
+    {
+        float *min_row = index->min_table + k * n, *min_prev = min_row - n;
+        float *max_row = index->max_table + k * n, *max_prev = max_row - n;
+        int half = 1 << (k - 1);
+        for (int i = 0; i + (1 << k) <= n; i++)
+        {
+            float a = min_prev[i], b = min_prev[i + half];
+            min_row[i] = a < b ? a : b;
+            a = max_prev[i], b = max_prev[i + half];
+            max_row[i] = a > b ? a : b;
+        }
+    }
+    return 0;
+}
+
+// first day with date >= date_str (upper: first day with date > date_str)
+static int find_day(QueryIndex *index, const char *date_str, int upper)
+{
+    int lo = 0, hi = index->count;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(index->days[mid].date_str, date_str);
+        if (cmp < 0 || (upper && cmp == 0))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// aggregate days [lo, hi) into response
+static void answer_range(QueryIndex *index, int lo, int hi, QueryResponse *response)
+{
+    int n = hi - lo;
+    if (n <= 0)
+    {
+        response->status = QUERY_STATUS_NOT_FOUND;
+        return;
+    }
+
+    int k = 0;
+    while ((2 << k) <= n)
+        k++;
+    float *min_row = index->min_table + k * index->count;
+    float *max_row = index->max_table + k * index->count;
+    float a = min_row[lo], b = min_row[hi - (1 << k)];
+    response->min_temperature = a < b ? a : b;
+    a = max_row[lo], b = max_row[hi - (1 << k)];
+    response->max_temperature = a > b ? a : b;
+
+    response->status = QUERY_STATUS_OK;
+    response->days = (uint32_t)n;
+    response->avg_temperature = (float)((index->sum_avg[hi] - index->sum_avg[lo]) / n);
+    response->avg_humidity = (float)((index->sum_humidity[hi] - index->sum_humidity[lo]) / n);
+    response->avg_wind_speed = (float)((index->sum_wind[hi] - index->sum_wind[lo]) / n);
+    snprintf(response->date_str, DATE_LEN, "%s", index->days[lo].date_str);
+}
+
+static void answer_request(QueryIndex *index, QueryRequest *request, QueryResponse *response)
+{
+    memset(response, 0, sizeof(*response));
+    response->id = request->id;
+
+    // never trust the peer to NUL-terminate
+    request->from[DATE_LEN - 1] = '\0';
+    request->to[DATE_LEN - 1] = '\0';
+
+    switch (request->op)
+    {
+    case QUERY_OP_LATEST:
+        answer_range(index, index->count > 0 ? index->count - 1 : 0, index->count, response);
+        break;
+    case QUERY_OP_DATE:
+    {
+        int lo = find_day(index, request->from, 0);
+        int found = lo < index->count && strcmp(index->days[lo].date_str, request->from) == 0;
+        answer_range(index, lo, found ? lo + 1 : lo, response);
+        break;
+    }
+    case QUERY_OP_RANGE:
+        answer_range(index, find_day(index, request->from, 0),
+                     find_day(index, request->to, 1), response);
+        break;
+    default:
+        response->status = QUERY_STATUS_BAD_REQUEST;
+        break;
+    }
+}
+
+static int set_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags < 0 ? -1 : fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+// write as much of the output buffer as the socket takes
+static int connection_flush(QueryConnection *conn)
+{
+    size_t sent = 0;
+    while (sent < conn->out_len)
+    {
+        ssize_t n = send(conn->fd, conn->out + sent, conn->out_len - sent, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        sent += (size_t)n;
+    }
+    memmove(conn->out, conn->out + sent, conn->out_len - sent);
+    conn->out_len -= sent;
+    return 0;
+}
+
+// answer every complete request that fits in the output buffer
+static void connection_process(QueryIndex *index, QueryConnection *conn)
+{
+    size_t used = 0;
+    while (conn->in_len - used >= sizeof(QueryRequest) &&
+           conn->out_len + sizeof(QueryResponse) <= sizeof(conn->out))
+    {
+        QueryRequest request;
+        QueryResponse response;
+        memcpy(&request, conn->in + used, sizeof(request));
+        answer_request(index, &request, &response);
+        memcpy(conn->out + conn->out_len, &response, sizeof(response));
+        conn->out_len += sizeof(response);
+        used += sizeof(request);
+    }
+    memmove(conn->in, conn->in + used, conn->in_len - used);
+    conn->in_len -= used;
+}
+
+// level-triggered: wait for input, or only for output while replies are queued
+static int connection_update(int epfd, QueryConnection *conn)
+{
+    struct epoll_event ev;
+    ev.events = conn->out_len > 0 ? EPOLLOUT : EPOLLIN;
+    ev.data.ptr = conn;
+    return epoll_ctl(epfd, EPOLL_CTL_MOD, conn->fd, &ev);
+}
+
+static void connection_close(int epfd, QueryConnection *conn)
+{
+    epoll_ctl(epfd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    free(conn);
+}
+
+// returns 0 to keep the connection, -1 to close it
+static int connection_event(QueryIndex *index, int epfd, QueryConnection *conn,
+                            uint32_t events)
+{
+    if (events & (EPOLLERR | EPOLLHUP) && !(events & EPOLLIN))
+        return -1;
+
+    if (events & EPOLLIN)
+    {
+        ssize_t n = read(conn->fd, conn->in + conn->in_len, sizeof(conn->in) - conn->in_len);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR))
+            return -1;
+        if (n > 0)
+            conn->in_len += (size_t)n;
+    }
+
+    connection_process(index, conn);
+    if (connection_flush(conn) != 0)
+        return -1;
+
+    // output drained: requests left waiting for buffer space can go now
+    if (conn->out_len == 0 && conn->in_len >= sizeof(QueryRequest))
+    {
+        connection_process(index, conn);
+        if (connection_flush(conn) != 0)
+            return -1;
+    }
+    return connection_update(epfd, conn);
+}
+
+// remove a socket file left behind by a server that is gone; returns -1 if
+// the path is not a socket or another server still listens on it
+static int remove_stale_socket(const struct sockaddr_un *addr)
+{
+    struct stat st;
+    if (lstat(addr->sun_path, &st) != 0)
+        return 0; // nothing there yet
+    if (!S_ISSOCK(st.st_mode))
+    {
+        printf("ERROR: '%s' exists and is not a socket.\n", addr->sun_path);
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    int live = connect(fd, (const struct sockaddr *)addr, sizeof(*addr)) == 0;
+    close(fd);
+    if (live)
+    {
+        printf("ERROR: A server is already listening on '%s'.\n", addr->sun_path);
+        return -1;
+    }
+    return unlink(addr->sun_path) == 0 ? 0 : -1;
+}
+
+static void accept_clients(int epfd, int listen_fd, int *reserve_fd, long *clients,
+                           long *refused)
+{
+    for (;;)
+    {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0 && (errno == EMFILE || errno == ENFILE) && *reserve_fd >= 0)
+        {
+            // out of descriptors: the client would stay pending and keep the
+            // listener readable, so free the spare, accept it and hang up
+            close(*reserve_fd);
+            int dropped = accept(listen_fd, NULL, NULL);
+            if (dropped >= 0)
+                close(dropped);
+            *reserve_fd = open("/dev/null", O_RDONLY);
+            if (dropped < 0)
+                return; // backlog drained
+            (*refused)++;
+            continue;
+        }
+        if (fd < 0)
+            return; // EAGAIN: backlog drained (or transient error)
+
+        QueryConnection *conn = (QueryConnection *)malloc(sizeof(QueryConnection));
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = conn;
+        if (!conn || set_nonblocking(fd) != 0 || epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0)
+        {
+            free(conn);
+            close(fd);
+            continue;
+        }
+        conn->fd = fd;
+        conn->in_len = 0;
+        conn->out_len = 0;
+        (*clients)++;
+    }
+}
+
+// --------------------------------------------------
+// server function
+// --------------------------------------------------
+
+// serve queries on socket_path until SIGINT/SIGTERM; returns 0 on clean exit
+int run_query_server(const char *socket_path, WeatherSystem *weather_system)
+{
+    QueryIndex index;
+    if (build_query_index(&index, weather_system) != 0)
+        return -1;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path))
+    {
+        printf("ERROR: Socket path '%s' is too long.\n", socket_path);
+        free_query_index(&index);
+        return -1;
+    }
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path);
+
+    // allow thousands of clients: raise the open file limit to the maximum
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    if (remove_stale_socket(&addr) != 0)
+    {
+        free_query_index(&index);
+        return -1;
+    }
+    int reserve_fd = open("/dev/null", O_RDONLY);
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    int epfd = epoll_create1(0);
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL; // NULL marks the listening socket
+    if (reserve_fd < 0 || listen_fd < 0 || epfd < 0 ||
+        bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(listen_fd, SOMAXCONN) != 0 || set_nonblocking(listen_fd) != 0 ||
+        epoll_ctl(epfd, EPOLL_CTL_ADD, listen_fd, &ev) != 0)
+    {
+        printf("ERROR: Could not listen on socket '%s'.\n", socket_path);
+        if (reserve_fd >= 0)
+            close(reserve_fd);
+        if (listen_fd >= 0)
+            close(listen_fd);
+        if (epfd >= 0)
+            close(epfd);
+        free_query_index(&index);
+        return -1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_stop_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    printf("Serving %d days on %s (Ctrl+C to stop)\n", index.count, socket_path);
+    fflush(stdout);
+
+    long clients = 0;
+    long refused = 0;
+    struct epoll_event events[QUERY_MAX_EVENTS];
+    while (!server_stop)
+    {
+        int n = epoll_wait(epfd, events, QUERY_MAX_EVENTS, -1);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            printf("ERROR: epoll_wait failed.\n");
+            break;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            QueryConnection *conn = (QueryConnection *)events[i].data.ptr;
+            if (conn == NULL)
+                accept_clients(epfd, listen_fd, &reserve_fd, &clients, &refused);
+            else if (connection_event(&index, epfd, conn, events[i].events) != 0)
+                connection_close(epfd, conn);
+        }
+    }
+
+    // connections still open are reclaimed by process exit
+    printf("Server stopped after %ld connections.\n", clients);
+    if (refused > 0)
+        printf("Refused %ld connections: out of file descriptors.\n", refused);
+    if (reserve_fd >= 0)
+        close(reserve_fd);
+    close(epfd);
+    close(listen_fd);
+    unlink(socket_path);
+    free_query_index(&index);
+    return 0;
+}
+
+#endif // __linux__
@@ -0,0 +1,477 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Segment Store Module
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Split the text log into one segment file per month (DIR/YYYY-MM.seg).
+ * - Keep a small manifest (DIR/MANIFEST) with days and date range per segment.
+ * - Retention: drop whole segments older than a given month.
+ * - Range queries: scan only overlapping segments, in parallel threads,
+ *   and merge the results in date order.
+ *
+ * Functions:
+ * - load_segment_manifest(SegmentManifest*, const char *dir)
+ * - save_segment_manifest(SegmentManifest*, const char *dir)
+ * - free_segment_manifest(SegmentManifest*)
+ * - segment_store_append(WeatherSystem*, const char *dir)
+ * - segment_store_retain(const char *dir, const char *oldest_month)
+ * - segment_store_scan(const char *dir, from, to, threads, WeatherSystem*)
+ */
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#define _POSIX_C_SOURCE 200809L // for mkdir() in strict C modes
+
+#include <stdio.h>     // for printf(), snprintf(), rename(), remove()
+#include <stdlib.h>    // for malloc(), realloc(), free()
+#include <string.h>    // for strcmp(), strncmp(), memmove(), strlen()
+#include <ctype.h>     // for isdigit()
+#include <errno.h>     // for errno, EEXIST
+#include <pthread.h>   // for pthread_create(), pthread_join()
+#if defined(_WIN32)
+#include <direct.h>    // for _mkdir()
+#else
+#include <sys/stat.h>  // for mkdir()
+#endif
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal types and helpers
+// --------------------------------------------------
+
+// work of one scan thread: every segment with index % threads == id
+typedef struct SegmentScanTask
+{
+    const char *dir;
+    const char *from;
+    const char *to;
+    SegmentInfo *segments;  // Segments overlapping [from, to]
+    WeatherSystem *results; // One result per segment
+    int count;              // Entries in segments[] and results[]
+    int id;                 // This thread's index
+    int threads;            // Total scan threads
+    int failed;             // Set if a segment could not be fully read
+} SegmentScanTask;
+
+static void segment_path(char *buffer, const char *dir, const char *name)
+{
+    snprintf(buffer, SEGMENT_PATH_LEN, "%s/%s", dir, name);
+}
+
+static void segment_file_path(char *buffer, const char *dir, const char *month)
+{
+    snprintf(buffer, SEGMENT_PATH_LEN, "%s/%s.seg", dir, month);
+}
+
+// find the segment for month, inserting an empty one in sorted position
+static SegmentInfo *find_or_add_segment(SegmentManifest *manifest, const char *month)
+{
+    int lo = 0, hi = manifest->count;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        int cmp = strcmp(manifest->segments[mid].month, month);
+        if (cmp == 0)
+            return &manifest->segments[mid];
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (manifest->count == manifest->capacity)
+    {
+        int capacity = manifest->capacity ? manifest->capacity * 2 : 16;
+        SegmentInfo *segments = (SegmentInfo *)realloc(manifest->segments,
+                                                       sizeof(SegmentInfo) * capacity);
+        if (!segments)
+        {
+            printf("ERROR: Failed to grow segment manifest.\n");
+            return NULL;
+        }
+        manifest->segments = segments;
+        manifest->capacity = capacity;
+    }
+
+    memmove(&manifest->segments[lo + 1], &manifest->segments[lo],
+            sizeof(SegmentInfo) * (manifest->count - lo));
+    manifest->count++;
+
+    SegmentInfo *info = &manifest->segments[lo];
+    memset(info, 0, sizeof(*info));
+    snprintf(info->month, MONTH_LEN, "%s", month);
+    return info;
+}
+
+// 1 if month is exactly "YYYY-MM" with a month of 01-12, so it orders
+// correctly against segment names with strcmp()
+static int is_segment_month(const char *month)
+{
+    if (strlen(month) != MONTH_LEN - 1 || month[4] != '-')
+        return 0;
+    for (int i = 0; i < MONTH_LEN - 1; i++)
+        if (i != 4 && !isdigit((unsigned char)month[i]))
+            return 0;
+    int mm = (month[5] - '0') * 10 + (month[6] - '0');
+    return mm >= 1 && mm <= 12;
+}
+
+static void *segment_scan_worker(void *arg)
+{
+    SegmentScanTask *task = (SegmentScanTask *)arg;
+
+    for (int i = task->id; i < task->count; i += task->threads)
+    {
+        char path[SEGMENT_PATH_LEN];
+        segment_file_path(path, task->dir, task->segments[i].month);
+
+        FILE *fptr;
+        FOPEN(fptr, path, "r");
+        if (fptr == NULL)
+        {
+            printf("ERROR: Missing segment '%s'.\n", path);
+            task->failed = 1;
+            continue;
+        }
+
+        WeatherSystem *result = &task->results[i];
+        DailyWeatherLog daily;
+        int status;
+        while ((status = read_daily_log(fptr, &daily)) != 0)
+        {
+            if (status < 0)
+            {
+                printf("ERROR: Malformed day in segment '%s'.\n", path);
+                task->failed = 1;
+                continue;
+            }
+            if (strcmp(daily.date_str, task->from) < 0 || strcmp(daily.date_str, task->to) > 0)
+                continue;
+            if (result->days_logged >= result->max_days &&
+                reserve_weather_system(result, result->max_days * 2 + 1) != 0)
+            {
+                task->failed = 1;
+                break;
+            }
+            add_daily_log(result, &daily);
+        }
+        fclose(fptr);
+
+        sort_daily_logs(result->logs, result->days_logged);
+    }
+    return NULL;
+}
+
+// --------------------------------------------------
+// Manifest functions
+// --------------------------------------------------
+
+// read DIR/MANIFEST; a missing manifest is an empty store
+int load_segment_manifest(SegmentManifest *manifest, const char *dir)
+{
+    memset(manifest, 0, sizeof(*manifest));
+
+    char path[SEGMENT_PATH_LEN];
+    segment_path(path, dir, SEGMENT_MANIFEST);
+
+    FILE *fptr;
+    FOPEN(fptr, path, "r");
+    if (fptr == NULL)
+        return 0;
+
+    char line[128];
+    while (fgets(line, sizeof(line), fptr) != NULL)
+    {
+        SegmentInfo parsed;
+        if (sscanf(line, "%7s %d %15s %15s", parsed.month, &parsed.days,
+                   parsed.first_date, parsed.last_date) != 4)
+            continue; // header line
+
+        SegmentInfo *info = find_or_add_segment(manifest, parsed.month);
+        if (!info)
+        {
+            fclose(fptr);
+            return -1;
+        }
+        *info = parsed;
+    }
+
+    fclose(fptr);
+    return manifest->count;
+}
+
+// rewrite DIR/MANIFEST atomically (temp file + rename)
+int save_segment_manifest(SegmentManifest *manifest, const char *dir)
+{
+    char path[SEGMENT_PATH_LEN];
+    char tmp_path[SEGMENT_PATH_LEN + 8];
+    segment_path(path, dir, SEGMENT_MANIFEST);
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    FILE *fptr;
+    FOPEN(fptr, tmp_path, "w");
+    if (fptr == NULL)
+    {
+        printf("ERROR: Could not write manifest '%s'.\n", tmp_path);
+        return -1;
+    }
+
+    fprintf(fptr, "WEATHER SEGMENT MANIFEST\n");
+    fprintf(fptr, "Segments: %d\n", manifest->count);
+    for (int i = 0; i < manifest->count; i++)
+    {
+        SegmentInfo *info = &manifest->segments[i];
+        fprintf(fptr, "%s %d %s %s\n", info->month, info->days,
+                info->first_date, info->last_date);
+    }
+    fclose(fptr);
+
+    if (rename(tmp_path, path) != 0)
+    {
+        printf("ERROR: Could not replace manifest '%s'.\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+void free_segment_manifest(SegmentManifest *manifest)
+{
+    if (!manifest)
+        return;
+    free(manifest->segments);
+    manifest->segments = NULL;
+    manifest->count = 0;
+    manifest->capacity = 0;
+}
+
+// --------------------------------------------------
+// Segment store functions
+// --------------------------------------------------
+
+// route every day of weather_system to its month segment
+// returns number of days written, or -1 on error
+int segment_store_append(WeatherSystem *weather_system, const char *dir)
+{
+    if (!weather_system || !dir)
+        return -1;
+
+#if defined(_WIN32)
+    if (_mkdir(dir) != 0 && errno != EEXIST)
+#else
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+#endif
+    {
+        printf("ERROR: Could not create segment directory '%s'.\n", dir);
+        return -1;
+    }
+
+    SegmentManifest manifest;
+    if (load_segment_manifest(&manifest, dir) < 0)
+        return -1;
+
+    // order days by date so each segment is opened once
+    int count = weather_system->days_logged;
+    DailyWeatherLog *days = (DailyWeatherLog *)malloc(sizeof(DailyWeatherLog) * (count ? count : 1));
+    if (!days)
+    {
+        printf("ERROR: Failed to allocate %d days for segment routing.\n", count);
+        free_segment_manifest(&manifest);
+        return -1;
+    }
+    memcpy(days, weather_system->logs, sizeof(DailyWeatherLog) * count);
+    int status = sort_daily_logs(days, count);
+
+    int written = 0;
+    for (int i = 0; status == 0 && i < count;)
+    {
+        char month[MONTH_LEN];
+        snprintf(month, MONTH_LEN, "%.7s", days[i].date_str);
+
+        char path[SEGMENT_PATH_LEN];
+        segment_file_path(path, dir, month);
+
+        // open before touching the manifest: a failure adds no empty entry
+        FILE *fptr;
+        FOPEN(fptr, path, "a");
+        SegmentInfo *info = fptr != NULL ? find_or_add_segment(&manifest, month) : NULL;
+        if (info == NULL)
+        {
+            printf("ERROR: Could not open segment '%s'.\n", path);
+            if (fptr != NULL)
+                fclose(fptr);
+            status = -1;
+            break;
+        }
+
+        for (; i < count && strncmp(days[i].date_str, month, 7) == 0; i++)
+        {
+            write_daily_log(fptr, &days[i]);
+            if (info->days == 0 || strcmp(days[i].date_str, info->first_date) < 0)
+                snprintf(info->first_date, DATE_LEN, "%s", days[i].date_str);
+            if (info->days == 0 || strcmp(days[i].date_str, info->last_date) > 0)
+                snprintf(info->last_date, DATE_LEN, "%s", days[i].date_str);
+            info->days++;
+            written++;
+        }
+        if (ferror(fptr) | fclose(fptr))
+        {
+            printf("ERROR: Could not write segment '%s'.\n", path);
+            status = -1;
+        }
+    }
+
+    // the manifest still lists the days that reached their segments
+    if (save_segment_manifest(&manifest, dir) != 0)
+        status = -1;
+    free(days);
+    free_segment_manifest(&manifest);
+    return status == 0 ? written : -1;
+}
+
+// drop every segment whose month is before oldest_month ("YYYY-MM")
+// returns number of segments removed, or -1 on error
+int segment_store_retain(const char *dir, const char *oldest_month)
+{
+    // segment names compare as strings: "2025-5" or "3" would drop too much
+    if (!is_segment_month(oldest_month))
+    {
+        printf("ERROR: Invalid month '%s'. Expected YYYY-MM (01-12).\n", oldest_month);
+        return -1;
+    }
+
+    SegmentManifest manifest;
+    if (load_segment_manifest(&manifest, dir) < 0)
+        return -1;
+
+    // manifest first, so a crash never leaves it pointing at deleted files
+    int dropped = 0;
+    while (dropped < manifest.count &&
+           strcmp(manifest.segments[dropped].month, oldest_month) < 0)
+        dropped++;
+
+    SegmentInfo *old = manifest.segments;
+    SegmentManifest kept = manifest;
+    kept.segments = old + dropped;
+    kept.count = manifest.count - dropped;
+    if (save_segment_manifest(&kept, dir) != 0)
+    {
+        free_segment_manifest(&manifest);
+        return -1;
+    }
+
+    for (int i = 0; i < dropped; i++)
+    {
+        char path[SEGMENT_PATH_LEN];
+        segment_file_path(path, dir, old[i].month);
+        if (remove(path) != 0)
+            printf("WARNING: Could not remove segment '%s'.\n", path);
+    }
+
+    free_segment_manifest(&manifest);
+    return dropped;
+}
+
+// collect days in [from, to] (inclusive "YYYY-MM-DD") into out, in date order
+// returns number of days found, or -1 on error
+int segment_store_scan(const char *dir, const char *from, const char *to,
+                       int threads, WeatherSystem *out)
+{
+    SegmentManifest manifest;
+    if (load_segment_manifest(&manifest, dir) < 0)
+        return -1;
+
+    // prune by manifest date ranges: untouched segments are never opened
+    int count = 0;
+    for (int i = 0; i < manifest.count; i++)
+    {
+        SegmentInfo *info = &manifest.segments[i];
+        if (strcmp(info->last_date, from) >= 0 && strcmp(info->first_date, to) <= 0)
+            manifest.segments[count++] = *info;
+    }
+
+    if (threads < 1)
+        threads = 1;
+    if (threads > MAX_SCAN_THREADS)
+        threads = MAX_SCAN_THREADS;
+    if (threads > count)
+        threads = count ? count : 1;
+
+    WeatherSystem *results = (WeatherSystem *)calloc(count ? count : 1, sizeof(WeatherSystem));
+    if (!results)
+    {
+        free_segment_manifest(&manifest);
+        return -1;
+    }
+    for (int i = 0; i < count; i++)
+        init_weather_system(&results[i], manifest.segments[i].days);
+
+    pthread_t workers[MAX_SCAN_THREADS];
+    int started[MAX_SCAN_THREADS];
+    SegmentScanTask tasks[MAX_SCAN_THREADS];
+    for (int t = 0; t < threads; t++)
+    {
+        SegmentScanTask task = {dir, from, to, manifest.segments, results, count, t, threads, 0};
+        tasks[t] = task;
+        started[t] = pthread_create(&workers[t], NULL, segment_scan_worker, &tasks[t]) == 0;
+        if (!started[t])
+            segment_scan_worker(&tasks[t]); // run inline if no thread available
+    }
+    int failed = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        if (started[t])
+            pthread_join(workers[t], NULL);
+        failed |= tasks[t].failed;
+    }
+
+    // segments are month partitions: concatenating in manifest order is sorted
+    int total = 0;
+    for (int i = 0; i < count; i++)
+        total += results[i].days_logged;
+
+    // a partial result is not a result: missing days would look like no data
+    int found = -1;
+    if (!failed && reserve_weather_system(out, out->days_logged + total) == 0)
+    {
+        for (int i = 0; i < count; i++)
+            for (int d = 0; d < results[i].days_logged; d++)
+                add_daily_log(out, &results[i].logs[d]);
+        found = total;
+    }
+
+    for (int i = 0; i < count; i++)
+        destroy_weather_system(&results[i]);
+    free(results);
+    free_segment_manifest(&manifest);
+    return found;
+}
@@ -0,0 +1,345 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Sharded Generation Module
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Split a run of `days` days over `count` processes (or machines):
+ *   shard i simulates days i, i + count, i + 2 * count ...
+ * - Reseed the RNG from (seed, day) before every day, so a day's
+ *   readings do not depend on which shard produced it.
+ * - Merge shard files back round robin (day d from shard d % count)
+ *   into one export identical to a single-process run (shard 0 of 1).
+ * - Fork a local process per shard and merge their files.
+ *
+ * Shard files are ordinary text logs with one extra header line,
+ * "Shard: I of K | Seed: S | Days: D"; a merged file is shard 0 of 1.
+ *
+ * Functions:
+ * - shard_day_seed(seed, day)
+ * - shard_days(days, index, count)
+ * - shard_generate(const char *outfile, days, index, count, seed)
+ * - read_shard_info(FILE*, ShardInfo*)
+ * - shard_merge(const char *outfile, int files, char *shard_files[])
+ * - shard_run_local(const char *outfile, days, count, seed)
+ */
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#define _POSIX_C_SOURCE 200809L // for fork(), waitpid() in strict C modes
+
+#include <stdio.h>  // for printf(), fprintf(), remove()
+#include <stdlib.h> // for srand(), calloc(), free()
+#include <string.h> // for memset()
+#if !defined(_WIN32)
+#include <sys/wait.h> // for waitpid()
+#include <unistd.h>   // for fork(), _exit()
+#endif
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal helpers
+// --------------------------------------------------
+
+#define SHARD_DAY_LINES 64 // Upper bound on lines of a day block
+
+// export header shared by shard files and merged files
+static void write_shard_header(FILE *fptr, ShardInfo *info)
+{
+    fprintf(fptr, "WEATHER SYSTEM LOG EXPORT\n");
+    fprintf(fptr, "Days Recorded: %ld\n", info->days_recorded);
+    fprintf(fptr, "Shard: %d of %d | Seed: %u | Days: %ld\n\n",
+            info->index, info->count, info->seed, info->days);
+}
+
+// copy the next day block written by write_daily_log() verbatim, from its
+// opening rule to its closing rule; the merge never reparses numbers
+// returns 1 if a day was copied, 0 at end of file, -1 on a damaged day
+static int copy_day_block(FILE *in, FILE *out)
+{
+    static const char rule[] = "==========";
+    char line[128];
+
+    // opening rule, directly followed by the "Date: " line
+    do
+    {
+        if (fgets(line, sizeof(line), in) == NULL)
+            return 0;
+    } while (strncmp(line, rule, sizeof(rule) - 1) != 0);
+    fputs(line, out);
+    if (fgets(line, sizeof(line), in) == NULL || strncmp(line, "Date: ", 6) != 0)
+        return -1;
+    fputs(line, out);
+
+    for (int lines = 0; lines < SHARD_DAY_LINES; lines++)
+    {
+        if (fgets(line, sizeof(line), in) == NULL)
+            return -1;
+        fputs(line, out);
+        if (strncmp(line, rule, sizeof(rule) - 1) == 0)
+            return 1;
+    }
+    return -1;
+}
+
+// --------------------------------------------------
+// sharding functions
+// --------------------------------------------------
+
+// RNG seed of one day of a run (splitmix64 finalizer of seed and day)
+uint32_t shard_day_seed(uint32_t seed, long day)
+{
+    uint64_t z = ((uint64_t)seed << 32) ^ (uint64_t)day;
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (uint32_t)(z ^ (z >> 31));
+}
+
+// number of days of a run that fall to shard `index`
+long shard_days(long days, int index, int count)
+{
+    return index < days ? (days - index + count - 1) / count : 0;
+}
+
+// simulate the days of shard `index` of `count` and write them to outfile
+// (replaced); returns 0 on success
+int shard_generate(const char *outfile, long days, int index, int count, uint32_t seed)
+{
+    FILE *fptr;
+    FOPEN(fptr, outfile, "w");
+    if (fptr == NULL)
+    {
+        printf("ERROR: Could not open file '%s' for writing.\n", outfile);
+        return -1;
+    }
+
+    ShardInfo info;
+    info.index = index;
+    info.count = count;
+    info.seed = seed;
+    info.days = days;
+    info.days_recorded = shard_days(days, index, count);
+    write_shard_header(fptr, &info);
+
+    for (long d = index; d < days; d += count)
+    {
+        DailyWeatherLog daily;
+        srand(shard_day_seed(seed, d));
+        init_daily_log(&daily);
+        simulate_daily_weather(&daily);
+        write_daily_log(fptr, &daily);
+    }
+
+    int failed = ferror(fptr);
+    if (fclose(fptr) != 0 || failed)
+    {
+        printf("ERROR: Could not write shard file '%s'.\n", outfile);
+        return -1;
+    }
+    return 0;
+}
+
+// parse the header lines of a shard file, up to the blank line after them
+// returns 0 if both "Days Recorded" and "Shard" lines were found
+int read_shard_info(FILE *fptr, ShardInfo *info)
+{
+    char line[128];
+    int found = 0;
+
+    memset(info, 0, sizeof(*info));
+    while (fgets(line, sizeof(line), fptr) != NULL && line[0] != '\n')
+    {
+        if (sscanf(line, "Days Recorded: %ld", &info->days_recorded) == 1)
+            found |= 1;
+        else if (sscanf(line, "Shard: %d of %d | Seed: %u | Days: %ld", &info->index,
+                        &info->count, &info->seed, &info->days) == 4)
+            found |= 2;
+    }
+    return found == 3 ? 0 : -1;
+}
+
+// merge all shard files of one run into outfile (replaced), day by day in
+// day order; returns 0 on success
+int shard_merge(const char *outfile, int files, char *shard_files[])
+{
+    if (files < 1 || files > MAX_SHARDS)
+    {
+        printf("ERROR: Expected 1-%d shard files.\n", MAX_SHARDS);
+        return -1;
+    }
+
+    // open every shard and put it at its own index
+    FILE **shards = (FILE **)calloc(files, sizeof(FILE *));
+    if (!shards)
+    {
+        printf("ERROR: Failed to allocate %d shards.\n", files);
+        return -1;
+    }
+
+    int status = 0;
+    ShardInfo run;
+    ShardInfo info;
+    long recorded = 0;
+    memset(&run, 0, sizeof(run));
+    for (int f = 0; f < files && status == 0; f++)
+    {
+        FILE *fptr;
+        FOPEN(fptr, shard_files[f], "r");
+        if (fptr == NULL)
+        {
+            printf("ERROR: Could not open file '%s' for reading.\n", shard_files[f]);
+            status = -1;
+        }
+        else if (read_shard_info(fptr, &info) != 0)
+        {
+            printf("ERROR: '%s' is not a shard file.\n", shard_files[f]);
+            status = -1;
+        }
+        else if (info.index >= 0 && info.index < files && shards[info.index] != NULL)
+        {
+            printf("ERROR: Shard %d of the run is given twice ('%s').\n",
+                   info.index, shard_files[f]);
+            status = -1;
+        }
+        else if (info.count != files || info.index < 0 || info.index >= files ||
+                 (f > 0 && (info.seed != run.seed || info.days != run.days)) ||
+                 info.days_recorded != shard_days(info.days, info.index, info.count))
+        {
+            printf("ERROR: Shard '%s' (%d of %d) does not belong to this run of %d shards.\n",
+                   shard_files[f], info.index, info.count, files);
+            status = -1;
+        }
+        else
+        {
+            shards[info.index] = fptr;
+            recorded += info.days_recorded;
+            run = info;
+            fptr = NULL;
+        }
+        if (fptr != NULL)
+            fclose(fptr);
+    }
+
+    FILE *out = NULL;
+    if (status == 0)
+        FOPEN(out, outfile, "w");
+    if (status == 0 && out == NULL)
+    {
+        printf("ERROR: Could not open file '%s' for writing.\n", outfile);
+        status = -1;
+    }
+
+    if (status == 0)
+    {
+        // the merged file is the single shard of a one-shard run
+        run.index = 0;
+        run.count = 1;
+        run.days_recorded = recorded;
+        write_shard_header(out, &run);
+
+        for (long d = 0; d < run.days && status == 0; d++)
+        {
+            int shard = (int)(d % files);
+            if (copy_day_block(shards[shard], out) != 1)
+            {
+                printf("ERROR: Shard %d ended early or is damaged at day %ld.\n", shard, d);
+                status = -1;
+            }
+        }
+
+        int failed = ferror(out);
+        if (fclose(out) != 0 || failed)
+        {
+            printf("ERROR: Could not write merged file '%s'.\n", outfile);
+            status = -1;
+        }
+    }
+
+    for (int f = 0; f < files; f++)
+        if (shards[f] != NULL)
+            fclose(shards[f]);
+    free(shards);
+    return status;
+}
+
+// run `count` shards as local processes, then merge them into outfile
+// returns 0 on success
+int shard_run_local(const char *outfile, long days, int count, uint32_t seed)
+{
+#if defined(_WIN32)
+    (void)outfile, (void)days, (void)count, (void)seed;
+    printf("ERROR: Local multi-process runs need fork(); run each shard separately.\n");
+    return -1;
+#else
+    char paths[MAX_SHARDS][SEGMENT_PATH_LEN];
+    char *files[MAX_SHARDS];
+    pid_t pids[MAX_SHARDS];
+    int status = 0;
+    int started = 0;
+
+    fflush(stdout); // children must not repeat buffered output
+    for (; started < count; started++)
+    {
+        snprintf(paths[started], SEGMENT_PATH_LEN, "%s.shard-%d", outfile, started);
+        files[started] = paths[started];
+
+        pids[started] = fork();
+        if (pids[started] == 0)
+            _exit(shard_generate(paths[started], days, started, count, seed) == 0 ? 0 : 1);
+        if (pids[started] < 0)
+        {
+            printf("ERROR: Could not start shard process %d.\n", started);
+            status = -1;
+            break;
+        }
+    }
+
+    for (int i = 0; i < started; i++)
+    {
+        int exit_status;
+        if (waitpid(pids[i], &exit_status, 0) != pids[i] ||
+            !WIFEXITED(exit_status) || WEXITSTATUS(exit_status) != 0)
+        {
+            printf("ERROR: Shard process %d failed.\n", i);
+            status = -1;
+        }
+    }
+
+    if (status == 0)
+        status = shard_merge(outfile, count, files);
+
+    for (int i = 0; i < started; i++)
+        remove(paths[i]);
+    return status;
+#endif
+}
@@ -0,0 +1,153 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Shared-Memory Publisher Module (POSIX)
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Create a POSIX shared-memory object holding a SharedWeatherSegment.
+ * - Publish every new reading with today's readings and running
+ *   avg/min/max, guarded by a seqlock: readers never block the writer
+ *   and never take a lock or make a syscall (see shm_reader.c).
+ *
+ * Single writer only: one weather_logger process per segment name.
+ *
+ * Functions:
+ * - shm_publisher_open(WeatherPublisher*, const char *name)
+ * - shm_publish_reading(WeatherPublisher*, const char *date_str, TemperatureLog*)
+ * - shm_publisher_close(WeatherPublisher*, int remove)
+ */
+
+// POSIX shared memory: Linux only (see README build instructions)
+#if defined(__linux__)
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#define _POSIX_C_SOURCE 200809L // for shm_open(), ftruncate(), mmap() in strict C modes
+
+#include <stdio.h>    // for printf()
+#include <string.h>   // for memset(), memcpy(), strcmp()
+#include <fcntl.h>    // for O_CREAT, O_RDWR
+#include <sys/mman.h> // for shm_open(), mmap(), munmap(), shm_unlink()
+#include <unistd.h>   // for ftruncate(), close()
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// publisher functions
+// --------------------------------------------------
+
+// create (or reuse) the shared-memory object and map it read-write
+int shm_publisher_open(WeatherPublisher *publisher, const char *name)
+{
+    memset(publisher, 0, sizeof(*publisher));
+    publisher->name = name;
+
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0 || ftruncate(fd, sizeof(SharedWeatherSegment)) != 0)
+    {
+        printf("ERROR: Could not create shared memory '%s'.\n", name);
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+
+    void *base = mmap(NULL, sizeof(SharedWeatherSegment), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        printf("ERROR: Could not map shared memory '%s'.\n", name);
+        return -1;
+    }
+    publisher->segment = (SharedWeatherSegment *)base;
+
+    // keep the sequence of a previous run even: readers may still be mapped
+    SharedWeatherSegment *segment = publisher->segment;
+    uint32_t seq = __atomic_load_n(&segment->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&segment->sequence, (seq + 1) | 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memset(&segment->snapshot, 0, sizeof(segment->snapshot));
+    segment->version = SHM_VERSION;
+    segment->magic = SHM_MAGIC;
+    __atomic_store_n(&segment->sequence, ((seq + 1) | 1u) + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+// fold a reading into the local snapshot and publish it under the seqlock
+void shm_publish_reading(WeatherPublisher *publisher, const char *date_str,
+                         TemperatureLog *entry)
+{
+    WeatherSnapshot *local = &publisher->local;
+    if (!publisher->segment || entry->hour < 0 || entry->hour >= DAILY_LOG)
+        return;
+
+    // a new day restarts the running statistics
+    if (local->hours == 0 || strcmp(local->date_str, date_str) != 0)
+    {
+        uint64_t published = local->published;
+        memset(local, 0, sizeof(*local));
+        snprintf(local->date_str, DATE_LEN, "%s", date_str);
+        local->published = published;
+        local->min_temperature = entry->temperature;
+        local->max_temperature = entry->temperature;
+    }
+
+    local->entries[entry->hour] = *entry;
+    local->latest = *entry;
+    local->avg_temperature += (entry->temperature - local->avg_temperature) / (float)(local->hours + 1);
+    local->hours++;
+    if (entry->temperature < local->min_temperature)
+        local->min_temperature = entry->temperature;
+    if (entry->temperature > local->max_temperature)
+        local->max_temperature = entry->temperature;
+    local->published++;
+
+    // seqlock write: odd sequence, copy, even sequence
+    SharedWeatherSegment *segment = publisher->segment;
+    uint32_t seq = __atomic_load_n(&segment->sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&segment->sequence, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&segment->snapshot, local, sizeof(*local));
+    __atomic_store_n(&segment->sequence, seq + 2, __ATOMIC_RELEASE);
+}
+
+// unmap; remove != 0 also deletes the shared-memory object
+void shm_publisher_close(WeatherPublisher *publisher, int remove)
+{
+    if (!publisher->segment)
+        return;
+    munmap(publisher->segment, sizeof(SharedWeatherSegment));
+    publisher->segment = NULL;
+    if (remove)
+        shm_unlink(publisher->name);
+}
+
+#endif // __linux__
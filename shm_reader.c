@@ -0,0 +1,161 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Shared-Memory Reader Library (POSIX)
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Map the publisher's segment read-only (one syscall at startup).
+ * - Take consistent snapshots with the seqlock: copy, then retry if the
+ *   writer was active meanwhile. No locks, no syscalls per snapshot.
+ * - Give up after SHM_SNAPSHOT_TIMEOUT_MS of retrying: a publisher that
+ *   died mid-update leaves the sequence odd forever.
+ *
+ * Dashboards only need this file and weather_logger.h.
+ *
+ * Functions:
+ * - shm_reader_open(WeatherReader*, const char *name)
+ * - shm_reader_snapshot(WeatherReader*, WeatherSnapshot*)
+ * - shm_reader_close(WeatherReader*)
+ */
+
+// POSIX shared memory: Linux only (see README build instructions)
+#if defined(__linux__)
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#define _POSIX_C_SOURCE 200809L // for shm_open(), mmap(), clock_gettime() in strict C modes
+
+#include <stdio.h>    // for printf()
+#include <string.h>   // for memcpy(), memset()
+#include <fcntl.h>    // for O_RDONLY
+#include <sys/mman.h> // for shm_open(), mmap(), munmap()
+#include <sys/stat.h> // for fstat()
+#include <time.h>     // for clock_gettime()
+#include <unistd.h>   // for close()
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal helpers
+// --------------------------------------------------
+
+#define SHM_CLOCK_CHECK_MASK 1023 // Read the clock every 1024 attempts
+
+static double reader_clock_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// --------------------------------------------------
+// reader functions
+// --------------------------------------------------
+
+// map a published segment; fails if no publisher ever created it
+int shm_reader_open(WeatherReader *reader, const char *name)
+{
+    memset(reader, 0, sizeof(*reader));
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        printf("ERROR: No shared memory '%s' (is weather_logger publishing?).\n", name);
+        return -1;
+    }
+
+    // a segment still being sized (or not ours) would fault on access
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SharedWeatherSegment))
+    {
+        printf("ERROR: Shared memory '%s' is too small for a weather segment.\n", name);
+        close(fd);
+        return -1;
+    }
+
+    void *base = mmap(NULL, sizeof(SharedWeatherSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        printf("ERROR: Could not map shared memory '%s'.\n", name);
+        return -1;
+    }
+
+    reader->segment = (const SharedWeatherSegment *)base;
+    if (reader->segment->magic != SHM_MAGIC || reader->segment->version != SHM_VERSION)
+    {
+        printf("ERROR: Shared memory '%s' has an unknown layout.\n", name);
+        shm_reader_close(reader);
+        return -1;
+    }
+    return 0;
+}
+
+// copy a consistent snapshot (retries while the writer is mid-update)
+// returns 0 on success, -1 if the writer stayed mid-update for
+// SHM_SNAPSHOT_TIMEOUT_MS (e.g. it died there)
+int shm_reader_snapshot(WeatherReader *reader, WeatherSnapshot *snapshot)
+{
+    const SharedWeatherSegment *segment = reader->segment;
+    double deadline = 0.0;
+    for (long attempt = 0;; attempt++)
+    {
+        // the clock is only read once the writer has kept us waiting
+        if ((attempt & SHM_CLOCK_CHECK_MASK) == SHM_CLOCK_CHECK_MASK)
+        {
+            double now = reader_clock_ms();
+            if (deadline == 0.0)
+                deadline = now + SHM_SNAPSHOT_TIMEOUT_MS;
+            else if (now >= deadline)
+                return -1;
+        }
+
+        uint32_t before = __atomic_load_n(&segment->sequence, __ATOMIC_ACQUIRE);
+        if ((before & 1u) == 0)
+        {
+            memcpy(snapshot, &segment->snapshot, sizeof(*snapshot));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&segment->sequence, __ATOMIC_RELAXED) == before)
+                return 0;
+        }
+        reader->retries++;
+    }
+}
+
+void shm_reader_close(WeatherReader *reader)
+{
+    if (!reader->segment)
+        return;
+    munmap((void *)reader->segment, sizeof(SharedWeatherSegment));
+    reader->segment = NULL;
+}
+
+#endif // __linux__
@@ -0,0 +1,327 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Top-K Query Module
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Find the K largest (or smallest) values of a metric, over hourly
+ *   readings or whole days, in one pass with O(K) memory.
+ * - Bounded heap per thread: its root is the worst value kept, and a
+ *   reading only touches the heap if it beats that threshold.
+ * - Hourly readings are compared against the threshold four at a time
+ *   (SSE2); scalar code is used elsewhere.
+ * - Days are split into one contiguous range per thread; the per-thread
+ *   heaps are merged into the final K.
+ *
+ * Ties are broken by position (earlier day/hour first), so the result
+ * does not depend on the number of threads.
+ *
+ * Functions:
+ * - top_k_query(WeatherSystem*, ExtremeQuery*, ExtremeReading *out)
+ */
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#include <stdio.h>   // for printf()
+#include <stdlib.h>  // for malloc(), free()
+#include <math.h>    // for INFINITY, isnan()
+#include <pthread.h> // for pthread_create(), pthread_join()
+#if defined(__SSE2__)
+#include <emmintrin.h> // for _mm_loadu_ps(), _mm_cmpgt_ps(), _MM_TRANSPOSE4_PS
+#endif
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal types and helpers
+// --------------------------------------------------
+
+// K best readings seen so far; items[0] is the worst of them
+typedef struct ExtremeHeap
+{
+    ExtremeReading *items; // Heap array of k entries
+    int size;              // Entries in use
+    int k;                 // Capacity
+    float sign;            // +1 ranks largest values first, -1 smallest
+    float threshold;       // Key to beat once full (-INFINITY before)
+} ExtremeHeap;
+
+// one thread's share of the days
+typedef struct TopKTask
+{
+    WeatherSystem *weather_system;
+    ExtremeQuery *query;
+    int first_day; // First day of the range
+    int last_day;  // One past the last day
+    ExtremeHeap heap;
+} TopKTask;
+
+static float hour_value(TemperatureLog *entry, WeatherMetric metric)
+{
+    switch (metric)
+    {
+    case METRIC_HUMIDITY:
+        return entry->humidity;
+    case METRIC_WIND_SPEED:
+        return entry->wind_speed;
+    default:
+        return entry->temperature;
+    }
+}
+
+// a ranks before b: larger key, then earlier position
+static int reading_before(const ExtremeReading *a, const ExtremeReading *b, float sign)
+{
+    float ka = sign * a->value, kb = sign * b->value;
+    if (ka != kb)
+        return ka > kb;
+    if (a->day != b->day)
+        return a->day < b->day;
+    return a->hour < b->hour;
+}
+
+static int init_heap(ExtremeHeap *heap, int k, float sign)
+{
+    heap->items = (ExtremeReading *)malloc(sizeof(ExtremeReading) * k);
+    heap->size = 0;
+    heap->k = k;
+    heap->sign = sign;
+    heap->threshold = -INFINITY;
+    if (!heap->items)
+    {
+        printf("ERROR: Failed to allocate top-%d heap.\n", k);
+        return -1;
+    }
+    return 0;
+}
+
+// restore the heap below i (the worst reading stays on top)
+static void heap_sift_down(ExtremeHeap *heap, int i)
+{
+    for (;;)
+    {
+        int worst = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < heap->size && reading_before(&heap->items[worst], &heap->items[left], heap->sign))
+            worst = left;
+        if (right < heap->size && reading_before(&heap->items[worst], &heap->items[right], heap->sign))
+            worst = right;
+        if (worst == i)
+            return;
+        ExtremeReading tmp = heap->items[i];
+        heap->items[i] = heap->items[worst];
+        heap->items[worst] = tmp;
+        i = worst;
+    }
+}
+
+static void heap_sift_up(ExtremeHeap *heap, int i)
+{
+    while (i > 0)
+    {
+        int parent = (i - 1) / 2;
+        if (!reading_before(&heap->items[parent], &heap->items[i], heap->sign))
+            return;
+        ExtremeReading tmp = heap->items[i];
+        heap->items[i] = heap->items[parent];
+        heap->items[parent] = tmp;
+        i = parent;
+    }
+}
+
+// keep the reading if it is among the k best so far
+static void heap_offer(ExtremeHeap *heap, float value, int day, int hour)
+{
+    ExtremeReading reading = {value, day, hour};
+    if (isnan(value))
+        return; // NaN never ranks
+
+    if (heap->size < heap->k)
+    {
+        heap->items[heap->size++] = reading;
+        heap_sift_up(heap, heap->size - 1);
+    }
+    else if (reading_before(&reading, &heap->items[0], heap->sign))
+    {
+        heap->items[0] = reading;
+        heap_sift_down(heap, 0);
+    }
+    else
+        return;
+
+    if (heap->size == heap->k)
+        heap->threshold = heap->sign * heap->items[0].value;
+}
+
+// offer the hourly readings of one day that beat the heap threshold;
+// days are scanned in order, so an equal key never beats the threshold
+static void scan_day_hours(ExtremeHeap *heap, DailyWeatherLog *daily_log, int day,
+                           WeatherMetric metric)
+{
+    int hour = 0;
+#if defined(__SSE2__)
+    // 4 TemperatureLog entries are a 4x4 float block: transpose it so one
+    // register holds the metric of 4 hours
+    const __m128 sign = _mm_set1_ps(heap->sign);
+    for (; hour + 4 <= DAILY_LOG; hour += 4)
+    {
+        const float *block = (const float *)&daily_log->entries[hour];
+        __m128 r0 = _mm_loadu_ps(block);
+        __m128 r1 = _mm_loadu_ps(block + 4);
+        __m128 r2 = _mm_loadu_ps(block + 8);
+        __m128 r3 = _mm_loadu_ps(block + 12);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3); // r1 temperature, r2 humidity, r3 wind
+
+        __m128 values = metric == METRIC_HUMIDITY ? r2 : metric == METRIC_WIND_SPEED ? r3 : r1;
+        __m128 keys = _mm_mul_ps(values, sign);
+        int mask = _mm_movemask_ps(_mm_cmpgt_ps(keys, _mm_set1_ps(heap->threshold)));
+        for (int lane = 0; mask != 0 && lane < 4; lane++)
+        {
+            if (mask & (1 << lane))
+                heap_offer(heap, hour_value(&daily_log->entries[hour + lane], metric),
+                           day, hour + lane);
+        }
+    }
+#endif
+    for (; hour < DAILY_LOG; hour++)
+    {
+        float value = hour_value(&daily_log->entries[hour], metric);
+        if (heap->sign * value > heap->threshold)
+            heap_offer(heap, value, day, hour);
+    }
+}
+
+static void *top_k_worker(void *arg)
+{
+    TopKTask *task = (TopKTask *)arg;
+    ExtremeQuery *query = task->query;
+    // the daily average has no hourly values: it is always ranked by day
+    int by_day = query->by_day || query->metric == METRIC_AVG_TEMPERATURE;
+
+    for (int d = task->first_day; d < task->last_day; d++)
+    {
+        DailyWeatherLog *daily_log = &task->weather_system->logs[d];
+        if (!by_day)
+        {
+            scan_day_hours(&task->heap, daily_log, d, query->metric);
+            continue;
+        }
+
+        float value = query->bottom ? day_metric_min(daily_log, query->metric)
+                                    : day_metric_max(daily_log, query->metric);
+        if (task->heap.sign * value > task->heap.threshold)
+            heap_offer(&task->heap, value, d, -1);
+    }
+    return NULL;
+}
+
+// --------------------------------------------------
+// top-K query function
+// --------------------------------------------------
+
+// best query->k readings (largest, or smallest if query->bottom) into out,
+// best first; out must hold query->k entries
+// returns number of results (< k if there are fewer readings), or -1
+int top_k_query(WeatherSystem *weather_system, ExtremeQuery *query, ExtremeReading *out)
+{
+    if (!weather_system || !query || !out || query->k < 1 ||
+        query->metric < 0 || query->metric >= METRIC_COUNT)
+        return -1;
+
+    int days = weather_system->days_logged;
+    int threads = query->threads < 1 ? 1 : query->threads;
+    if (threads > MAX_SCAN_THREADS)
+        threads = MAX_SCAN_THREADS;
+    if (threads > days)
+        threads = days > 0 ? days : 1;
+    float sign = query->bottom ? -1.0f : 1.0f;
+
+    pthread_t workers[MAX_SCAN_THREADS];
+    int started[MAX_SCAN_THREADS];
+    TopKTask tasks[MAX_SCAN_THREADS];
+    int status = 0;
+    int ready = 0;
+    for (; ready < threads; ready++)
+    {
+        TopKTask *task = &tasks[ready];
+        task->weather_system = weather_system;
+        task->query = query;
+        task->first_day = (int)((long)days * ready / threads);
+        task->last_day = (int)((long)days * (ready + 1) / threads);
+        if (init_heap(&task->heap, query->k, sign) != 0)
+        {
+            status = -1;
+            break;
+        }
+    }
+
+    for (int t = 0; t < ready && status == 0; t++)
+    {
+        started[t] = pthread_create(&workers[t], NULL, top_k_worker, &tasks[t]) == 0;
+        if (!started[t])
+            top_k_worker(&tasks[t]); // run inline if no thread available
+    }
+    for (int t = 0; t < ready && status == 0; t++)
+        if (started[t])
+            pthread_join(workers[t], NULL);
+
+    // merge: the k best of all per-thread heaps
+    ExtremeHeap final;
+    final.items = out;
+    final.size = 0;
+    final.k = query->k;
+    final.sign = sign;
+    final.threshold = -INFINITY;
+    for (int t = 0; t < ready && status == 0; t++)
+        for (int i = 0; i < tasks[t].heap.size; i++)
+        {
+            ExtremeReading *reading = &tasks[t].heap.items[i];
+            heap_offer(&final, reading->value, reading->day, reading->hour);
+        }
+
+    for (int t = 0; t < ready; t++)
+        free(tasks[t].heap.items);
+    if (status != 0)
+        return -1;
+
+    // heap sort in place: moving the worst reading to the back each time
+    // leaves out[] best first
+    int found = final.size;
+    while (final.size > 1)
+    {
+        ExtremeReading worst = final.items[0];
+        final.items[0] = final.items[--final.size];
+        final.items[final.size] = worst;
+        heap_sift_down(&final, 0);
+    }
+    return found;
+}
@@ -39,14 +39,18 @@
  * - get_random_date_str(char *buffer)
  * - get_random_float(min, max)
  * - seed_rnd() (seed rand())
+ * - get_monotonic_ms() (timing helper)
+ * - sleep_ms(ms)
  */
 
 // --------------------------------------------------
 // header files
 // --------------------------------------------------
+#define _POSIX_C_SOURCE 200809L // for clock_gettime(), nanosleep() in strict C modes
+
 #include <stdio.h>  // for printf()
 #include <stdlib.h> // for rand(), srand(), RAND_MAX macro
-#include <time.h>   // for time()
+#include <time.h>   // for time(), clock_gettime(), nanosleep()
 
 #include "weather_logger.h"
 
@@ -62,6 +66,46 @@ void display_help(const char *s)
     printf(" -v --version\tShow program version\n");
     printf(" -n DAYS\tSimulate multiple days\n");
     printf(" -o FILE\tOutput weather logs to custom filename\n");
+    printf(" --wal WALFILE DAYS [FILE]\n");
+    printf("\t\tLog every reading durably, checkpoint days to FILE\n");
+    printf(" --segments DIR DAYS\tAppend DAYS to monthly segments in DIR\n");
+    printf(" --retain DIR YYYY-MM\tDrop segments older than YYYY-MM\n");
+    printf(" --query DIR FROM TO [THREADS] [FILE]\n");
+    printf("\t\tScan days FROM..TO (YYYY-MM-DD) in parallel\n");
+    printf(" --filter FILE [--all] PRED...\n");
+    printf("\t\tDays matching e.g. temp>27 wind>6 (any, or --all)\n");
+    printf(" --compact IN OUT [RUN_DAYS]\n");
+    printf("\t\tSort days by date with bounded memory, drop repeats\n");
+    printf(" --detect FILE [Z] [SHORT LONG]\n");
+    printf("\t\tReport readings more than Z std devs from normal\n");
+    printf(" --columnar IN OUT\tExport a text log as a columnar file\n");
+    printf(" --column FILE NAME\tRead one column (date, temp, humidity, wind,\n");
+    printf("\t\tavg, min, max) of a columnar file\n");
+#if defined(__linux__)
+    printf(" --serve SOCKET FILE\tServe queries on FILE over a Unix socket\n");
+    printf(" --client SOCKET latest | date D | range FROM TO\n");
+    printf("\t\tQuery a running server\n");
+    printf(" --load-test SOCKET CLIENTS REQUESTS\n");
+    printf("\t\tBenchmark a running server with concurrent clients\n");
+    printf(" --publish NAME DAYS [DELAY_MS]\n");
+    printf("\t\tPublish readings to shared memory NAME (e.g. /weather_logger)\n");
+    printf(" --peek NAME\tRead the latest snapshot from shared memory NAME\n");
+#endif
+    printf(" --top FILE METRIC K [hours|days] [THREADS]\n");
+    printf("\t\tK largest temp, humidity, wind or avg readings\n");
+    printf(" --bottom FILE METRIC K [hours|days] [THREADS]\n");
+    printf("\t\tK smallest readings, likewise\n");
+    printf(" --correlate FILE [--days] [--range FROM TO] [LAG] [THREADS]\n");
+    printf("\t\tMeans, covariances and correlations of temp, humidity, wind\n");
+    printf(" --shard OUT DAYS I K [SEED]\n");
+    printf("\t\tSimulate shard I of K of a DAYS run (days I, I+K, ...)\n");
+    printf(" --merge-shards OUT SHARD...\n");
+    printf("\t\tMerge the shard files of a run in day order\n");
+    printf(" --shards OUT DAYS K [SEED]\n");
+    printf("\t\tRun K local shard processes and merge them into OUT\n");
+    printf(" --loadgen WALFILE STATIONS RATE SECONDS [FILE]\n");
+    printf("\t\tReplay readings at RATE/s (0 = max) and report latencies\n");
+    printf("\t\t(WALFILE is a new scratch file, deleted afterwards)\n");
 }
 
 // display program version
@@ -125,4 +169,33 @@ float get_random_float(float min, float max)
 void seed_rnd()
 {
     srand(time(NULL));
-}
\ No newline at end of file
+}
+
+// monotonic clock in milliseconds (for commit windows and latencies)
+double get_monotonic_ms(void)
+{
+#if defined(_MSC_VER)
+    return (double)clock() * 1000.0 / CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+}
+
+// pause the calling thread for ms milliseconds
+void sleep_ms(double ms)
+{
+    if (ms <= 0.0)
+        return;
+#if defined(_MSC_VER)
+    clock_t end = clock() + (clock_t)(ms * CLOCKS_PER_SEC / 1000.0);
+    while (clock() < end)
+        ;
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ms / 1000.0);
+    ts.tv_nsec = (long)((ms - ts.tv_sec * 1000.0) * 1000000.0);
+    nanosleep(&ts, NULL);
+#endif
+}
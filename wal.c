@@ -0,0 +1,552 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Write-Ahead Log Module
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Make every hourly reading durable before it is acknowledged.
+ * - Group commit: batch many appends into one fsync, bounded by
+ *   WAL_GROUP_RECORDS readings or WAL_GROUP_WINDOW_MS of waiting.
+ * - Replay the log into a WeatherSystem on startup.
+ * - Checkpoint finished days into the text log and truncate the WAL.
+ *
+ * A reading with LSN n is durable once wal->durable_lsn >= n.
+ *
+ * A checkpoint is bracketed by marker records: WAL_MARK_BEGIN (fsynced
+ * before the text log is touched) saves the text log's size and identity
+ * (device and inode, or a hash of its path); the WAL is then replaced by a
+ * file holding only WAL_MARK_DONE with the last LSN, which keeps numbering
+ * monotonic. A BEGIN found on replay means the checkpoint never finished:
+ * the same text log is cut back to the saved size and the days are
+ * checkpointed again, so a crash never duplicates them. A different text
+ * log is never truncated.
+ *
+ * Functions:
+ * - wal_open(WriteAheadLog*, const char *filename)
+ * - wal_append(WriteAheadLog*, const char *date_str, TemperatureLog*)
+ * - wal_commit(WriteAheadLog*)
+ * - wal_commit_expired(WriteAheadLog*)
+ * - wal_replay(const char *filename, const char *outfile, WeatherSystem*,
+ *              DailyWeatherLog*, int*)
+ * - wal_checkpoint(WriteAheadLog*, WeatherSystem*, const char *outfile)
+ * - wal_close(WriteAheadLog*)
+ */
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#define _POSIX_C_SOURCE 200809L // for fileno(), fsync(), ftruncate() in strict C modes
+
+#include <stdio.h>    // for printf(), fwrite(), fread(), rename()
+#include <stddef.h>   // for offsetof()
+#include <string.h>   // for memset(), memcpy(), strcmp(), strlen()
+#include <sys/stat.h> // for fstat()
+#if defined(_WIN32)
+#include <io.h> // for _commit(), _chsize()
+#else
+#include <unistd.h> // for fsync(), ftruncate()
+#endif
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal helpers
+// --------------------------------------------------
+
+// FNV-1a hash of a byte range
+static uint32_t wal_hash(const void *data, size_t size)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    const unsigned char *end = p + size;
+    uint32_t hash = 2166136261u;
+
+    while (p < end)
+    {
+        hash ^= *p++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// checksum of a record slot, skipping magic and checksum fields
+static uint32_t wal_checksum(const void *record, size_t size)
+{
+    return wal_hash((const unsigned char *)record + offsetof(WalRecord, lsn),
+                    size - offsetof(WalRecord, lsn));
+}
+
+// classify a record slot read from disk: 1 for a reading, 2 for a
+// checkpoint marker (copied to *marker), 0 for a torn or foreign record
+static int wal_record_kind(const WalRecord *record, WalMarker *marker)
+{
+    if (record->magic == WAL_MAGIC)
+        return record->checksum == wal_checksum(record, sizeof(*record)) ? 1 : 0;
+    if (record->magic != WAL_MARK_MAGIC)
+        return 0;
+
+    memcpy(marker, record, sizeof(*marker));
+    if (marker->checksum != wal_checksum(marker, sizeof(*marker)))
+        return 0;
+    return (marker->kind == WAL_MARK_BEGIN || marker->kind == WAL_MARK_DONE) ? 2 : 0;
+}
+
+// build a checkpoint marker covering every reading up to lsn; a BEGIN
+// takes the text log's size and identity from `outfile` (NULL for DONE)
+static void wal_make_marker(WalMarker *marker, int kind, uint64_t lsn,
+                            const WalMarker *outfile)
+{
+    memset(marker, 0, sizeof(*marker));
+    marker->magic = WAL_MARK_MAGIC;
+    marker->lsn = lsn;
+    marker->kind = kind;
+    if (outfile != NULL)
+    {
+        marker->outfile_size = outfile->outfile_size;
+        marker->outfile_hash = outfile->outfile_hash;
+        marker->outfile_dev = outfile->outfile_dev;
+        marker->outfile_ino = outfile->outfile_ino;
+    }
+    marker->checksum = wal_checksum(marker, sizeof(*marker));
+}
+
+// fill the outfile_* fields of `id` from an open text log
+static int wal_outfile_identity(FILE *fptr, const char *filename, WalMarker *id)
+{
+    struct stat st;
+    if (fflush(fptr) != 0 || fstat(fileno(fptr), &st) != 0)
+        return -1;
+
+    memset(id, 0, sizeof(*id));
+    id->outfile_size = (int64_t)st.st_size;
+    id->outfile_hash = wal_hash(filename, strlen(filename));
+    id->outfile_dev = (uint64_t)st.st_dev;
+    id->outfile_ino = (uint64_t)st.st_ino;
+    return 0;
+}
+
+// 1 if two identities name the same file: by device and inode where the
+// platform has them, by path otherwise
+static int wal_same_outfile(const WalMarker *a, const WalMarker *b)
+{
+    if (a->outfile_ino != 0 || b->outfile_ino != 0)
+        return a->outfile_dev == b->outfile_dev && a->outfile_ino == b->outfile_ino;
+    return a->outfile_hash == b->outfile_hash;
+}
+
+// cut an open file back to `size` bytes
+static int wal_truncate_stream(FILE *fptr, long size)
+{
+    if (fflush(fptr) != 0)
+        return -1;
+#if defined(_WIN32)
+    return _chsize(_fileno(fptr), size) == 0 ? 0 : -1;
+#else
+    return ftruncate(fileno(fptr), (off_t)size) == 0 ? 0 : -1;
+#endif
+}
+
+// cut a file back to `size` bytes
+static int wal_truncate_file(const char *filename, long size)
+{
+    FILE *fptr;
+    FOPEN(fptr, filename, "r+b");
+    if (fptr == NULL)
+        return -1;
+    int status = wal_truncate_stream(fptr, size);
+    if (fclose(fptr) != 0)
+        status = -1;
+    return status;
+}
+
+// undo the appends of an unfinished checkpoint: cut outfile back to the
+// size saved in its BEGIN marker, but only if it is the same file
+static int wal_rollback_outfile(const char *outfile, const WalMarker *begin)
+{
+    FILE *fptr;
+    FOPEN(fptr, outfile, "r+b");
+    if (fptr == NULL)
+        return 0; // no text log: the checkpoint wrote nothing here
+
+    WalMarker current;
+    int status = 0;
+    if (wal_outfile_identity(fptr, outfile, &current) != 0)
+    {
+        printf("ERROR: Could not stat '%s'.\n", outfile);
+        status = -1;
+    }
+    else if (!wal_same_outfile(begin, &current))
+        printf("WARNING: Unfinished checkpoint in WAL was into another log; "
+               "'%s' is left as is.\n", outfile);
+    else if (current.outfile_size > begin->outfile_size)
+    {
+        printf("WARNING: Rolling back unfinished checkpoint in '%s' to %lld bytes.\n",
+               outfile, (long long)begin->outfile_size);
+        if (wal_truncate_stream(fptr, (long)begin->outfile_size) != 0)
+        {
+            printf("ERROR: Could not truncate '%s'.\n", outfile);
+            status = -1;
+        }
+    }
+    if (fclose(fptr) != 0)
+        status = -1;
+    return status;
+}
+
+// start an empty day for the given date (no random date, unlike init_daily_log)
+static void wal_begin_day(DailyWeatherLog *daily_log, const char *date_str)
+{
+    memset(daily_log, 0, sizeof(*daily_log));
+    snprintf(daily_log->date_str, DATE_LEN, "%s", date_str);
+    for (int i = 0; i < DAILY_LOG; i++)
+        daily_log->entries[i].hour = i;
+}
+
+// close a replayed day: compute stats and store it
+static int wal_finish_day(WeatherSystem *weather_system, DailyWeatherLog *daily_log)
+{
+    if (weather_system->days_logged >= weather_system->max_days &&
+        reserve_weather_system(weather_system, weather_system->max_days * 2 + 1) != 0)
+        return -1;
+
+    compute_statistics(daily_log);
+    add_daily_log(weather_system, daily_log);
+    return 0;
+}
+
+// --------------------------------------------------
+// WAL functions
+// --------------------------------------------------
+
+// open (or create) the WAL for appending; LSNs continue after existing records
+int wal_open(WriteAheadLog *wal, const char *filename)
+{
+    if (!wal || !filename)
+        return -1;
+
+    memset(wal, 0, sizeof(*wal));
+    wal->filename = filename;
+    wal->next_lsn = 1;
+
+    // find the last valid LSN; a checkpointed WAL starts with a DONE marker
+    // carrying the last LSN, so numbering stays monotonic across restarts
+    FILE *fptr;
+    FOPEN(fptr, filename, "rb");
+    if (fptr != NULL)
+    {
+        WalRecord record;
+        WalMarker marker;
+        long valid_end = 0;
+        int kind;
+        while (fread(&record, sizeof(record), 1, fptr) == 1 &&
+               (kind = wal_record_kind(&record, &marker)) != 0)
+        {
+            uint64_t lsn = kind == 1 ? record.lsn : marker.lsn;
+            if (lsn + 1 > wal->next_lsn)
+                wal->next_lsn = lsn + 1;
+            valid_end += (long)sizeof(record);
+        }
+        fseek(fptr, 0, SEEK_END);
+        long size = ftell(fptr);
+        fclose(fptr);
+
+        // a torn tail from a crash mid-write is dropped before appending
+        if (size != valid_end)
+        {
+            printf("WARNING: Dropping %ld torn bytes at end of WAL '%s'.\n",
+                   size - valid_end, filename);
+            if (wal_truncate_file(filename, valid_end) != 0)
+            {
+                printf("ERROR: Could not truncate WAL '%s'.\n", filename);
+                return -1;
+            }
+        }
+    }
+    wal->durable_lsn = wal->next_lsn - 1;
+
+    FOPEN(wal->fptr, filename, "ab");
+    if (wal->fptr == NULL)
+    {
+        printf("ERROR: Could not open WAL '%s' for appending.\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+// queue one reading; commits the group when it is full or its window expired
+// returns the reading's LSN, or 0 if it was refused (the group is still full
+// after a failed commit) or its group commit failed
+uint64_t wal_append(WriteAheadLog *wal, const char *date_str, TemperatureLog *entry)
+{
+    if (!wal || !wal->fptr || !date_str || !entry)
+        return 0;
+
+    // a failed commit leaves the group full: retry it before queueing more
+    if (wal->pending_count >= WAL_GROUP_RECORDS && wal_commit(wal) != 0)
+        return 0;
+
+    double now = get_monotonic_ms();
+    if (wal->pending_count == 0)
+        wal->first_pending_ms = now;
+
+    WalRecord *record = &wal->pending[wal->pending_count++];
+    memset(record, 0, sizeof(*record));
+    record->magic = WAL_MAGIC;
+    record->lsn = wal->next_lsn++;
+    snprintf(record->date_str, DATE_LEN, "%s", date_str);
+    record->entry = *entry;
+    record->checksum = wal_checksum(record, sizeof(*record));
+    uint64_t lsn = record->lsn;
+
+    if ((wal->pending_count >= WAL_GROUP_RECORDS ||
+         now - wal->first_pending_ms >= WAL_GROUP_WINDOW_MS) &&
+        wal_commit(wal) != 0)
+        return 0;
+
+    return lsn;
+}
+
+// write all pending readings with one fsync; returns 0 on success
+int wal_commit(WriteAheadLog *wal)
+{
+    if (!wal || !wal->fptr)
+        return -1;
+    if (wal->pending_count == 0)
+        return 0;
+
+    if (fwrite(wal->pending, sizeof(WalRecord), wal->pending_count, wal->fptr) !=
+            (size_t)wal->pending_count ||
+        fflush(wal->fptr) != 0 || FSYNC(wal->fptr) != 0)
+    {
+        printf("ERROR: Could not commit %d readings to WAL '%s'.\n",
+               wal->pending_count, wal->filename);
+        return -1;
+    }
+
+    wal->durable_lsn = wal->pending[wal->pending_count - 1].lsn;
+    wal->pending_count = 0;
+    wal->syncs++;
+    return 0;
+}
+
+// commit the group if its oldest reading has waited WAL_GROUP_WINDOW_MS;
+// callers poll this when no new reading arrives to close the window
+int wal_commit_expired(WriteAheadLog *wal)
+{
+    if (!wal || wal->pending_count == 0)
+        return 0;
+    if (get_monotonic_ms() - wal->first_pending_ms < WAL_GROUP_WINDOW_MS)
+        return 0;
+    return wal_commit(wal);
+}
+
+// rebuild days from the WAL; the unfinished last day (if any) goes to partial.
+// If a checkpoint into outfile was interrupted, outfile is cut back to its
+// size before that checkpoint (the WAL still holds those days).
+// returns number of readings kept, or -1 on error
+int wal_replay(const char *filename, const char *outfile, WeatherSystem *weather_system,
+               DailyWeatherLog *partial, int *partial_hours)
+{
+    if (!filename || !weather_system || !partial || !partial_hours)
+        return -1;
+
+    *partial_hours = 0;
+
+    FILE *fptr;
+    FOPEN(fptr, filename, "rb");
+    if (fptr == NULL)
+        return 0; // no WAL yet: nothing to recover
+
+    WalRecord record;
+    WalMarker marker;
+    WalMarker rollback;
+    int has_rollback = 0;
+    memset(&rollback, 0, sizeof(rollback));
+    int readings = 0;
+    int hours = 0;
+    int dropped = 0;
+    while (fread(&record, sizeof(record), 1, fptr) == 1)
+    {
+        int kind = wal_record_kind(&record, &marker);
+        if (kind == 0)
+            break; // torn tail: stop at the last complete record
+        if (kind == 2)
+        {
+            // the first unfinished BEGIN has the text log state to go back to
+            if (marker.kind == WAL_MARK_BEGIN && !has_rollback)
+            {
+                rollback = marker;
+                has_rollback = 1;
+            }
+            continue;
+        }
+
+        int hour = record.entry.hour;
+        if (hour < 0 || hour >= DAILY_LOG)
+            continue;
+
+        // a day is only rebuilt from hours 0, 1, 2 ... of one date in order:
+        // a new date, a gap or a repeated hour drops the day being rebuilt
+        if (hours > 0 && (strcmp(partial->date_str, record.date_str) != 0 || hour != hours))
+        {
+            dropped++;
+            readings -= hours;
+            hours = 0;
+        }
+        if (hours == 0 && hour != 0)
+            continue; // no start of day: wait for the next hour 0
+
+        if (hours == 0)
+            wal_begin_day(partial, record.date_str);
+        partial->entries[hour] = record.entry;
+        hours++;
+        readings++;
+
+        if (hours == DAILY_LOG)
+        {
+            if (wal_finish_day(weather_system, partial) != 0)
+                break;
+            hours = 0;
+        }
+    }
+    fclose(fptr);
+
+    if (dropped > 0)
+        printf("WARNING: Dropped %d incomplete or out-of-order days from WAL '%s'.\n",
+               dropped, filename);
+
+    // days from an interrupted checkpoint may already be (partly) in outfile
+    if (outfile != NULL && has_rollback && wal_rollback_outfile(outfile, &rollback) != 0)
+        return -1;
+
+    *partial_hours = hours;
+    return readings;
+}
+
+// append days finished since the last checkpoint to outfile, then truncate
+// the WAL; call at a day boundary (an unfinished day would be dropped)
+int wal_checkpoint(WriteAheadLog *wal, WeatherSystem *weather_system,
+                   const char *outfile)
+{
+    if (!wal || !weather_system || wal_commit(wal) != 0)
+        return -1;
+
+    // without a destination the WAL is the only copy: keep it
+    if (outfile == NULL || wal->checkpoint_day >= weather_system->days_logged)
+        return 0;
+
+    // record which text log is written and where it ends before touching it
+    FILE *fptr;
+    FOPEN(fptr, outfile, "a");
+    if (fptr == NULL)
+    {
+        printf("ERROR: Could not open '%s' for writing; WAL kept.\n", outfile);
+        return -1;
+    }
+    WalMarker id;
+    WalMarker marker;
+    if (wal_outfile_identity(fptr, outfile, &id) != 0)
+    {
+        printf("ERROR: Could not stat '%s'; WAL kept.\n", outfile);
+        fclose(fptr);
+        return -1;
+    }
+    wal_make_marker(&marker, WAL_MARK_BEGIN, wal->durable_lsn, &id);
+    if (fwrite(&marker, sizeof(marker), 1, wal->fptr) != 1 ||
+        fflush(wal->fptr) != 0 || FSYNC(wal->fptr) != 0)
+    {
+        printf("ERROR: Could not write checkpoint marker to WAL '%s'.\n", wal->filename);
+        fclose(fptr);
+        return -1;
+    }
+
+    for (int i = wal->checkpoint_day; i < weather_system->days_logged; i++)
+        write_daily_log(fptr, &weather_system->logs[i]);
+
+    // the text log must be on disk before the WAL copy goes away; on a
+    // short write the partial days are cut off again and the WAL is kept
+    int failed = fflush(fptr) != 0 || ferror(fptr) || FSYNC(fptr) != 0;
+    if (failed)
+        wal_truncate_stream(fptr, (long)id.outfile_size);
+    if (fclose(fptr) != 0)
+        failed = 1;
+    if (failed)
+    {
+        printf("ERROR: Could not write days to '%s'; WAL kept.\n", outfile);
+        return -1;
+    }
+
+    // replace the WAL with one holding only the LSN base (temp file + rename);
+    // a crash before the rename leaves the BEGIN marker for replay to undo
+    char tmp_path[WAL_PATH_LEN];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", wal->filename);
+    wal_make_marker(&marker, WAL_MARK_DONE, wal->durable_lsn, NULL);
+    FOPEN(fptr, tmp_path, "wb");
+    if (fptr == NULL || fwrite(&marker, sizeof(marker), 1, fptr) != 1 ||
+        fflush(fptr) != 0 || FSYNC(fptr) != 0)
+    {
+        printf("ERROR: Could not write '%s'; WAL kept.\n", tmp_path);
+        if (fptr != NULL)
+            fclose(fptr);
+        return -1;
+    }
+    fclose(fptr);
+
+    fclose(wal->fptr);
+#if defined(_WIN32)
+    remove(wal->filename); // rename() does not replace on Windows
+#endif
+    int status = 0;
+    if (rename(tmp_path, wal->filename) != 0)
+    {
+        printf("ERROR: Could not replace WAL '%s'.\n", wal->filename);
+        status = -1;
+    }
+    FOPEN(wal->fptr, wal->filename, "ab");
+    if (wal->fptr == NULL)
+    {
+        printf("ERROR: Could not reopen WAL '%s'.\n", wal->filename);
+        return -1;
+    }
+    if (status != 0)
+        return status;
+
+    wal->checkpoint_day = weather_system->days_logged;
+    return 0;
+}
+
+// commit anything pending and close the file
+void wal_close(WriteAheadLog *wal)
+{
+    if (!wal || !wal->fptr)
+        return;
+    wal_commit(wal);
+    fclose(wal->fptr);
+    wal->fptr = NULL;
+}
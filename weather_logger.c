@@ -40,12 +40,40 @@
 // --------------------------------------------------
 static void run_single_day(const char *outfile);
 static void run_multiple_days(int days, const char *outfile);
+static int run_extended_command(int argc, char *argv[]);
+static int run_wal_days(const char *walfile, int days, const char *outfile);
+static int run_segment_days(const char *dir, int days);
+static int run_segment_query(const char *dir, const char *from, const char *to,
+                             int threads, const char *outfile);
+static int run_filter(const char *filename, int argc, char *argv[]);
+static int run_compact(const char *infile, const char *outfile, int run_days);
+static int run_detect(const char *filename, double z_threshold, int short_window,
+                      int long_window);
+static int run_columnar_export(const char *infile, const char *outfile);
+static int run_column_scan(const char *filename, const char *name);
+#if defined(__linux__)
+static int run_server(const char *socket_path, const char *filename);
+static int run_client(const char *socket_path, int argc, char *argv[]);
+static int run_publish(const char *name, int days, double delay_ms);
+static int run_peek(const char *name);
+#endif
+static int run_shard(const char *outfile, long days, int index, int count,
+                     uint32_t seed);
+static int run_top_k(const char *filename, int argc, char *argv[], int bottom);
+static int run_correlate(const char *filename, int argc, char *argv[]);
+static int run_loadgen(const char *walfile, int stations, double rate,
+                       double seconds, const char *outfile);
 
 // --------------------------------------------------
 // Main function (argument parsing)
 // --------------------------------------------------
 int main(int argc, char *argv[])
 {
+    // long commands (--wal ...) take a variable number of arguments
+    if (argc >= 2 && strncmp(argv[1], "--", 2) == 0 &&
+        strcmp(argv[1], "--help") != 0 && strcmp(argv[1], "--version") != 0)
+        return run_extended_command(argc, argv);
+
     if (argc == 1)
     {
         // default: simulate 1 day, print to console only
@@ -184,3 +212,849 @@ static void run_multiple_days(int days, const char *outfile)
 
     destroy_weather_system(&weather_system);
 }
+
+// --------------------------------------------------
+// Long commands dispatcher
+// --------------------------------------------------
+static int run_extended_command(int argc, char *argv[])
+{
+    // --wal WALFILE DAYS [FILE] -> durable hourly appends
+    if (strcmp(argv[1], "--wal") == 0 && (argc == 4 || argc == 5))
+    {
+        int days = atoi(argv[3]);
+        if (days < 1 || days > MAX_DAYS)
+        {
+            printf("Invalid DAYS value. Must be 1-%d\n", MAX_DAYS);
+            return 1;
+        }
+        return run_wal_days(argv[2], days, argc == 5 ? argv[4] : NULL);
+    }
+    // --segments DIR DAYS -> append days to monthly segment files
+    else if (strcmp(argv[1], "--segments") == 0 && argc == 4)
+    {
+        int days = atoi(argv[3]);
+        if (days < 1 || days > MAX_ARCHIVE_DAYS)
+        {
+            printf("Invalid DAYS value. Must be 1-%d\n", MAX_ARCHIVE_DAYS);
+            return 1;
+        }
+        return run_segment_days(argv[2], days);
+    }
+    // --retain DIR YYYY-MM -> drop segments older than the month
+    else if (strcmp(argv[1], "--retain") == 0 && argc == 4)
+    {
+        int dropped = segment_store_retain(argv[2], argv[3]);
+        if (dropped < 0)
+            return 1;
+        printf("Dropped %d segments older than %s\n", dropped, argv[3]);
+        return 0;
+    }
+    // --query DIR FROM TO [THREADS] [FILE] -> parallel range scan
+    else if (strcmp(argv[1], "--query") == 0 && argc >= 5 && argc <= 7)
+    {
+        int threads = argc >= 6 ? atoi(argv[5]) : 1;
+        return run_segment_query(argv[2], argv[3], argv[4], threads,
+                                 argc == 7 ? argv[6] : NULL);
+    }
+    // --filter FILE [--all] PRED... -> threshold query using zone maps
+    else if (strcmp(argv[1], "--filter") == 0 && argc >= 4)
+    {
+        return run_filter(argv[2], argc - 3, argv + 3);
+    }
+    // --compact IN OUT [RUN_DAYS] -> sort by date and drop repeated dates
+    else if (strcmp(argv[1], "--compact") == 0 && (argc == 4 || argc == 5))
+    {
+        int run_days = argc == 5 ? atoi(argv[4]) : SORT_RUN_DAYS;
+        if (run_days < 1)
+        {
+            printf("Invalid RUN_DAYS value. Must be at least 1\n");
+            return 1;
+        }
+        return run_compact(argv[2], argv[3], run_days);
+    }
+    // --detect FILE [Z] -> stream readings through the anomaly detector
+    else if (strcmp(argv[1], "--detect") == 0 && (argc == 3 || argc == 4 || argc == 6))
+    {
+        double z_threshold = argc >= 4 ? atof(argv[3]) : ANOMALY_Z_THRESHOLD;
+        if (z_threshold <= 0.0)
+        {
+            printf("Invalid Z value. Must be greater than 0\n");
+            return 1;
+        }
+        // window lengths in readings, e.g. 1440 10080 for minute data
+        int short_window = argc == 6 ? atoi(argv[4]) : ANOMALY_SHORT_WINDOW;
+        int long_window = argc == 6 ? atoi(argv[5]) : ANOMALY_LONG_WINDOW;
+        if (short_window < 2 || long_window < short_window)
+        {
+            printf("Invalid SHORT or LONG value. SHORT >= 2, LONG >= SHORT\n");
+            return 1;
+        }
+        return run_detect(argv[2], z_threshold, short_window, long_window);
+    }
+    // --columnar IN OUT -> convert a text log to the columnar format
+    else if (strcmp(argv[1], "--columnar") == 0 && argc == 4)
+    {
+        return run_columnar_export(argv[2], argv[3]);
+    }
+    // --column FILE NAME -> read one column of a columnar file
+    else if (strcmp(argv[1], "--column") == 0 && argc == 4)
+    {
+        return run_column_scan(argv[2], argv[3]);
+    }
+#if defined(__linux__)
+    // epoll, Unix sockets and POSIX shared memory: Linux only
+    // --serve SOCKET FILE -> resident query daemon
+    else if (strcmp(argv[1], "--serve") == 0 && argc == 4)
+    {
+        return run_server(argv[2], argv[3]);
+    }
+    // --client SOCKET latest | date D | range FROM TO
+    else if (strcmp(argv[1], "--client") == 0 && argc >= 4)
+    {
+        return run_client(argv[2], argc - 3, argv + 3);
+    }
+    // --load-test SOCKET CLIENTS REQUESTS -> concurrent clients benchmark
+    else if (strcmp(argv[1], "--load-test") == 0 && argc == 5)
+    {
+        int clients = atoi(argv[3]);
+        long requests = atol(argv[4]);
+        if (clients < 1 || requests < 1)
+        {
+            printf("Invalid CLIENTS or REQUESTS value. Must be at least 1\n");
+            return 1;
+        }
+        return query_load_test(argv[2], clients, requests) == 0 ? 0 : 1;
+    }
+    // --publish NAME DAYS [DELAY_MS] -> shared-memory latest readings
+    else if (strcmp(argv[1], "--publish") == 0 && (argc == 4 || argc == 5))
+    {
+        int days = atoi(argv[3]);
+        if (days < 1 || days > MAX_ARCHIVE_DAYS)
+        {
+            printf("Invalid DAYS value. Must be 1-%d\n", MAX_ARCHIVE_DAYS);
+            return 1;
+        }
+        return run_publish(argv[2], days, argc == 5 ? atof(argv[4]) : 0.0);
+    }
+    // --peek NAME -> read a snapshot like a dashboard would
+    else if (strcmp(argv[1], "--peek") == 0 && argc == 3)
+    {
+        return run_peek(argv[2]);
+    }
+#endif
+    // --shard OUT DAYS I K [SEED] -> simulate days I, I+K, I+2K ... of a run
+    else if (strcmp(argv[1], "--shard") == 0 && (argc == 6 || argc == 7))
+    {
+        long days = atol(argv[3]);
+        int index = atoi(argv[4]);
+        int count = atoi(argv[5]);
+        if (days < 1 || count < 1 || count > MAX_SHARDS || index < 0 || index >= count)
+        {
+            printf("Invalid shard. DAYS >= 1, K 1-%d, 0 <= I < K\n", MAX_SHARDS);
+            return 1;
+        }
+        uint32_t seed = argc == 7 ? (uint32_t)strtoul(argv[6], NULL, 10) : SHARD_DEFAULT_SEED;
+        return run_shard(argv[2], days, index, count, seed);
+    }
+    // --merge-shards OUT SHARD... -> one export, identical to a 1-shard run
+    else if (strcmp(argv[1], "--merge-shards") == 0 && argc >= 4)
+    {
+        if (shard_merge(argv[2], argc - 3, argv + 3) != 0)
+            return 1;
+        printf("Merged %d shards into: %s\n", argc - 3, argv[2]);
+        return 0;
+    }
+    // --shards OUT DAYS K [SEED] -> K local processes, then merge
+    else if (strcmp(argv[1], "--shards") == 0 && (argc == 5 || argc == 6))
+    {
+        long days = atol(argv[3]);
+        int count = atoi(argv[4]);
+        if (days < 1 || count < 1 || count > MAX_SHARDS)
+        {
+            printf("Invalid DAYS or K value. DAYS >= 1, K 1-%d\n", MAX_SHARDS);
+            return 1;
+        }
+        uint32_t seed = argc == 6 ? (uint32_t)strtoul(argv[5], NULL, 10) : SHARD_DEFAULT_SEED;
+        double start = get_monotonic_ms();
+        if (shard_run_local(argv[2], days, count, seed) != 0)
+            return 1;
+        printf("Simulated %ld days in %d processes (%.1f ms) into: %s\n",
+               days, count, get_monotonic_ms() - start, argv[2]);
+        return 0;
+    }
+    // --top / --bottom FILE METRIC K [hours|days] [THREADS] -> extreme readings
+    else if ((strcmp(argv[1], "--top") == 0 || strcmp(argv[1], "--bottom") == 0) &&
+             argc >= 5 && argc <= 7)
+    {
+        return run_top_k(argv[2], argc - 3, argv + 3, strcmp(argv[1], "--bottom") == 0);
+    }
+    // --correlate FILE [--days] [--range FROM TO] [LAG] [THREADS] -> cross-metric statistics
+    else if (strcmp(argv[1], "--correlate") == 0 && argc >= 3 && argc <= 9)
+    {
+        return run_correlate(argv[2], argc - 3, argv + 3);
+    }
+    // --loadgen WALFILE STATIONS RATE SECONDS [FILE] -> end-to-end latency
+    else if (strcmp(argv[1], "--loadgen") == 0 && (argc == 6 || argc == 7))
+    {
+        int stations = atoi(argv[3]);
+        double rate = atof(argv[4]);
+        double seconds = atof(argv[5]);
+        if (stations < 1 || stations > LOADGEN_MAX_STATIONS)
+        {
+            printf("Invalid STATIONS value. Must be 1-%d\n", LOADGEN_MAX_STATIONS);
+            return 1;
+        }
+        if (rate < 0.0 || seconds <= 0.0)
+        {
+            printf("Invalid RATE or SECONDS value. RATE >= 0, SECONDS > 0\n");
+            return 1;
+        }
+        return run_loadgen(argv[2], stations, rate, seconds, argc == 7 ? argv[6] : NULL);
+    }
+
+    printf("Invalid input.\n");
+    display_help(argv[0]);
+    return 1;
+}
+
+// --------------------------------------------------
+// Run simulation with every hourly reading logged to a WAL
+// --------------------------------------------------
+static int run_wal_days(const char *walfile, int days, const char *outfile)
+{
+    WeatherSystem weather_system;
+    init_weather_system(&weather_system, days);
+
+    // recover readings not yet checkpointed by a previous run
+    DailyWeatherLog daily;
+    int start_hour = 0;
+    int replayed = wal_replay(walfile, outfile, &weather_system, &daily, &start_hour);
+    if (replayed < 0)
+    {
+        destroy_weather_system(&weather_system);
+        return 1;
+    }
+    if (replayed > 0)
+        printf("Recovered %d readings (%d full days) from WAL: %s\n",
+               replayed, weather_system.days_logged, walfile);
+
+    // live anomaly alerts; recovered readings only warm the windows up
+    AnomalyDetector detector;
+    if (init_anomaly_detector(&detector, ANOMALY_SHORT_WINDOW, ANOMALY_LONG_WINDOW,
+                              ANOMALY_Z_THRESHOLD) != 0)
+    {
+        destroy_weather_system(&weather_system);
+        return 1;
+    }
+    for (int i = 0; i < weather_system.days_logged; i++)
+        for (int hour = 0; hour < DAILY_LOG; hour++)
+            anomaly_detector_update(&detector, weather_system.logs[i].date_str,
+                                    &weather_system.logs[i].entries[hour], NULL, NULL);
+    for (int hour = 0; hour < start_hour; hour++)
+        anomaly_detector_update(&detector, daily.date_str, &daily.entries[hour], NULL, NULL);
+    long warm_anomalies = detector.anomalies;
+
+    WriteAheadLog wal;
+    if (wal_open(&wal, walfile) != 0)
+    {
+        destroy_anomaly_detector(&detector);
+        destroy_weather_system(&weather_system);
+        return 1;
+    }
+
+    if (reserve_weather_system(&weather_system, weather_system.days_logged + days) != 0)
+    {
+        wal_close(&wal);
+        destroy_anomaly_detector(&detector);
+        destroy_weather_system(&weather_system);
+        return 1;
+    }
+
+    int readings = 0;
+    int status = 0;
+    for (int i = 0; i < days && status == 0; i++)
+    {
+        // resume an interrupted day first, otherwise start a fresh one
+        if (start_hour == 0)
+            init_daily_log(&daily);
+
+        for (int hour = start_hour; hour < DAILY_LOG && status == 0; hour++)
+        {
+            simulate_hour_record(&daily, hour);
+            if (wal_append(&wal, daily.date_str, &daily.entries[hour]) == 0)
+                status = -1;
+            else
+            {
+                readings++;
+                anomaly_detector_update(&detector, daily.date_str, &daily.entries[hour],
+                                        print_anomaly_event, NULL);
+            }
+        }
+        start_hour = 0;
+        if (status != 0)
+            break;
+
+        compute_statistics(&daily);
+        add_daily_log(&weather_system, &daily);
+
+        if ((i + 1) % WAL_CHECKPOINT_DAYS == 0)
+            status = wal_checkpoint(&wal, &weather_system, outfile);
+    }
+
+    if (status == 0)
+    {
+        if (outfile != NULL)
+            printf("Saving log to file: %s\n", outfile);
+        status = wal_checkpoint(&wal, &weather_system, outfile);
+    }
+
+    if (status == 0)
+        printf("WAL: %d readings, %lu fsyncs (%.1f readings per fsync), durable LSN %llu\n",
+               readings, wal.syncs, wal.syncs ? (double)readings / wal.syncs : 0.0,
+               (unsigned long long)wal.durable_lsn);
+    else
+        printf("ERROR: WAL run stopped after %d readings; durable LSN %llu.\n",
+               readings, (unsigned long long)wal.durable_lsn);
+    printf("Anomalies: %ld (|z| > %.1f)\n", detector.anomalies - warm_anomalies,
+           detector.z_threshold);
+
+    wal_close(&wal);
+    destroy_anomaly_detector(&detector);
+    destroy_weather_system(&weather_system);
+    return status == 0 ? 0 : 1;
+}
+
+// --------------------------------------------------
+// Simulate days into the monthly segment store
+// --------------------------------------------------
+static int run_segment_days(const char *dir, int days)
+{
+    WeatherSystem weather_system;
+    init_weather_system(&weather_system, days);
+
+    for (int i = 0; i < days; i++)
+    {
+        DailyWeatherLog daily;
+        init_daily_log(&daily);
+        simulate_daily_weather(&daily);
+        add_daily_log(&weather_system, &daily);
+    }
+
+    int written = segment_store_append(&weather_system, dir);
+    destroy_weather_system(&weather_system);
+    if (written < 0)
+        return 1;
+
+    printf("Stored %d days in segments under: %s\n", written, dir);
+    return 0;
+}
+
+// --------------------------------------------------
+// Query a date range from the segment store
+// --------------------------------------------------
+static int run_segment_query(const char *dir, const char *from, const char *to,
+                             int threads, const char *outfile)
+{
+    WeatherSystem weather_system;
+    init_weather_system(&weather_system, 0);
+
+    int found = segment_store_scan(dir, from, to, threads, &weather_system);
+    if (found < 0)
+    {
+        destroy_weather_system(&weather_system);
+        return 1;
+    }
+
+    printf("Days from %s to %s: %d\n", from, to, found);
+    if (outfile != NULL)
+    {
+        printf("Saving log to file: %s\n", outfile);
+        save_system_logs(&weather_system, outfile);
+    }
+    else
+    {
+        for (int i = 0; i < weather_system.days_logged; i++)
+            print_daily_summary(&weather_system.logs[i]);
+    }
+
+    destroy_weather_system(&weather_system);
+    return 0;
+}
+
+// --------------------------------------------------
+// Threshold query over a text log, pruned by its zone maps
+// --------------------------------------------------
+static int run_filter(const char *filename, int argc, char *argv[])
+{
+    WeatherFilter filter;
+    filter.count = 0;
+    filter.match_all = 0;
+
+    for (int i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--all") == 0)
+            filter.match_all = 1;
+        else if (filter.count >= MAX_PREDICATES ||
+                 parse_weather_predicate(argv[i], &filter.predicates[filter.count++]) != 0)
+        {
+            printf("Invalid predicate '%s'. Use METRIC>VALUE or METRIC<VALUE\n", argv[i]);
+            printf("with METRIC one of temp, humidity, wind, avg (max %d).\n", MAX_PREDICATES);
+            return 1;
+        }
+    }
+    if (filter.count == 0)
+    {
+        printf("Invalid input. At least one predicate is required.\n");
+        return 1;
+    }
+
+    // reuse FILE.zmap when it matches the file, otherwise rebuild it
+    ZoneMapIndex index;
+    if (load_zone_maps(&index, filename) < 0)
+    {
+        if (build_file_zone_maps(filename, &index) < 0)
+            return 1;
+        save_zone_maps(&index, filename);
+    }
+
+    WeatherSystem matches;
+    init_weather_system(&matches, 0);
+
+    int scanned = zone_map_filter_file(filename, &index, &filter, &matches);
+    if (scanned >= 0)
+    {
+        for (int i = 0; i < matches.days_logged; i++)
+            print_daily_summary(&matches.logs[i]);
+        printf("Matching days: %d (scanned %d of %d blocks)\n",
+               matches.days_logged, scanned, index.count);
+    }
+
+    free_zone_maps(&index);
+    destroy_weather_system(&matches);
+    return scanned < 0 ? 1 : 0;
+}
+
+// --------------------------------------------------
+// Compact a text log: external sort by date, deduplicated
+// --------------------------------------------------
+static int run_compact(const char *infile, const char *outfile, int run_days)
+{
+    SortStats stats;
+    if (external_sort_logs(infile, outfile, run_days, &stats) != 0)
+        return 1;
+
+    printf("Compacted %s -> %s\n", infile, outfile);
+    printf("Days read: %ld, written: %ld, duplicates dropped: %ld\n",
+           stats.days_in, stats.days_out, stats.duplicates);
+    printf("Sorted runs: %d (%d days each at most), merge passes: %d\n",
+           stats.runs, run_days, stats.passes);
+    return 0;
+}
+
+// --------------------------------------------------
+// Replay a text log hour by hour through the anomaly detector
+// --------------------------------------------------
+static int run_detect(const char *filename, double z_threshold, int short_window,
+                      int long_window)
+{
+    FILE *fptr;
+    FOPEN(fptr, filename, "r");
+    if (fptr == NULL)
+    {
+        printf("ERROR: Could not open file '%s' for reading.\n", filename);
+        return 1;
+    }
+
+    AnomalyDetector detector;
+    if (init_anomaly_detector(&detector, short_window, long_window, z_threshold) != 0)
+    {
+        fclose(fptr);
+        return 1;
+    }
+
+    DailyWeatherLog daily;
+    double busy_ms = 0.0;
+    int status;
+    while ((status = read_daily_log(fptr, &daily)) != 0)
+    {
+        if (status < 0)
+            continue;
+
+        double start = get_monotonic_ms();
+        for (int hour = 0; hour < DAILY_LOG; hour++)
+            anomaly_detector_update(&detector, daily.date_str, &daily.entries[hour],
+                                    print_anomaly_event, NULL);
+        busy_ms += get_monotonic_ms() - start;
+    }
+    fclose(fptr);
+
+    printf("Readings: %ld, anomalies: %ld (|z| > %.1f, windows %d / %d readings)\n",
+           detector.samples, detector.anomalies, detector.z_threshold,
+           short_window, long_window);
+    if (busy_ms > 0.0)
+        printf("Detector time: %.2f ms (%.0f readings/s)\n",
+               busy_ms, detector.samples / (busy_ms / 1000.0));
+
+    destroy_anomaly_detector(&detector);
+    return 0;
+}
+
+// --------------------------------------------------
+// Convert a text log into a columnar analytics file
+// --------------------------------------------------
+static int run_columnar_export(const char *infile, const char *outfile)
+{
+    WeatherSystem weather_system;
+    init_weather_system(&weather_system, 0);
+
+    int status = 1;
+    if (load_system_logs(&weather_system, infile) >= 0)
+    {
+        printf("Saving %d days to columnar file: %s\n",
+               weather_system.days_logged, outfile);
+        status = save_system_columnar(&weather_system, outfile) == 0 ? 0 : 1;
+    }
+
+    destroy_weather_system(&weather_system);
+    return status;
+}
+
+// --------------------------------------------------
+// Project one column of a columnar file (other columns are not read)
+// --------------------------------------------------
+static int run_column_scan(const char *filename, const char *name)
+{
+    ColumnId column;
+    if (parse_column_name(name, &column) != 0)
+    {
+        printf("Invalid column '%s'. Use date, temp, humidity, wind, avg, min or max\n", name);
+        return 1;
+    }
+
+    ColumnarFile file;
+    if (columnar_open(&file, filename) != 0)
+        return 1;
+
+    size_t count;
+    const void *values = columnar_column(&file, column, &count);
+    printf("Column %s: %zu values over %u days\n", name, count, file.days);
+
+    if (count > 0 && column == COLUMN_DATE)
+    {
+        const char(*dates)[DATE_LEN] = (const char(*)[DATE_LEN])values;
+        printf("First date: %s, last date: %s\n", dates[0], dates[count - 1]);
+    }
+    else if (count > 0)
+    {
+        const float *floats = (const float *)values;
+        double sum = 0.0;
+        float min = floats[0], max = floats[0];
+        for (size_t i = 0; i < count; i++)
+        {
+            sum += floats[i];
+            if (floats[i] < min)
+                min = floats[i];
+            if (floats[i] > max)
+                max = floats[i];
+        }
+        printf("Mean: %.2f, Min: %.1f, Max: %.1f\n", sum / count, min, max);
+    }
+
+    columnar_close(&file);
+    return 0;
+}
+
+#if defined(__linux__)
+// --------------------------------------------------
+// Load a text log and serve queries on a Unix socket
+// --------------------------------------------------
+static int run_server(const char *socket_path, const char *filename)
+{
+    WeatherSystem weather_system;
+    init_weather_system(&weather_system, 0);
+
+    int status = 1;
+    if (load_system_logs(&weather_system, filename) >= 0)
+        status = run_query_server(socket_path, &weather_system) == 0 ? 0 : 1;
+
+    destroy_weather_system(&weather_system);
+    return status;
+}
+
+// --------------------------------------------------
+// Send one query to a running server and print the answer
+// --------------------------------------------------
+static int run_client(const char *socket_path, int argc, char *argv[])
+{
+    QueryRequest request;
+    memset(&request, 0, sizeof(request));
+
+    if (argc == 1 && strcmp(argv[0], "latest") == 0)
+        request.op = QUERY_OP_LATEST;
+    else if (argc == 2 && strcmp(argv[0], "date") == 0)
+    {
+        request.op = QUERY_OP_DATE;
+        snprintf(request.from, DATE_LEN, "%s", argv[1]);
+    }
+    else if (argc == 3 && strcmp(argv[0], "range") == 0)
+    {
+        request.op = QUERY_OP_RANGE;
+        snprintf(request.from, DATE_LEN, "%s", argv[1]);
+        snprintf(request.to, DATE_LEN, "%s", argv[2]);
+    }
+    else
+    {
+        printf("Invalid query. Use: latest | date YYYY-MM-DD | range FROM TO\n");
+        return 1;
+    }
+
+    QueryResponse response;
+    if (query_client_request(socket_path, &request, &response) != 0)
+        return 1;
+
+    print_query_response(&response);
+    return response.status == QUERY_STATUS_OK ? 0 : 1;
+}
+
+// --------------------------------------------------
+// Simulate readings and publish each one to shared memory
+// --------------------------------------------------
+static int run_publish(const char *name, int days, double delay_ms)
+{
+    // live anomaly alerts on the readings as they are published
+    AnomalyDetector detector;
+    if (init_anomaly_detector(&detector, ANOMALY_SHORT_WINDOW, ANOMALY_LONG_WINDOW,
+                              ANOMALY_Z_THRESHOLD) != 0)
+        return 1;
+
+    WeatherPublisher publisher;
+    if (shm_publisher_open(&publisher, name) != 0)
+    {
+        destroy_anomaly_detector(&detector);
+        return 1;
+    }
+
+    printf("Publishing %d days of readings to shared memory: %s\n", days, name);
+    fflush(stdout);
+
+    double start = get_monotonic_ms();
+    for (int i = 0; i < days; i++)
+    {
+        DailyWeatherLog daily;
+        init_daily_log(&daily);
+        for (int hour = 0; hour < DAILY_LOG; hour++)
+        {
+            simulate_hour_record(&daily, hour);
+            shm_publish_reading(&publisher, daily.date_str, &daily.entries[hour]);
+            anomaly_detector_update(&detector, daily.date_str, &daily.entries[hour],
+                                    print_anomaly_event, NULL);
+            sleep_ms(delay_ms);
+        }
+    }
+    double elapsed = get_monotonic_ms() - start;
+
+    printf("Published %llu readings in %.1f ms, %ld anomalies (|z| > %.1f)\n",
+           (unsigned long long)publisher.local.published, elapsed,
+           detector.anomalies, detector.z_threshold);
+    destroy_anomaly_detector(&detector);
+
+    // the segment stays so dashboards keep the last snapshot
+    shm_publisher_close(&publisher, 0);
+    return 0;
+}
+
+// --------------------------------------------------
+// Read the published snapshot (dashboard stand-in)
+// --------------------------------------------------
+static int run_peek(const char *name)
+{
+    WeatherReader reader;
+    if (shm_reader_open(&reader, name) != 0)
+        return 1;
+
+    WeatherSnapshot snapshot;
+    int status = shm_reader_snapshot(&reader, &snapshot);
+    if (status == 0)
+        print_weather_snapshot(&snapshot);
+    else
+        printf("ERROR: Shared memory '%s' stayed mid-update (publisher died?).\n", name);
+
+    shm_reader_close(&reader);
+    return status == 0 ? 0 : 1;
+}
+#endif
+
+// --------------------------------------------------
+// Simulate one shard of a multi-process run
+// --------------------------------------------------
+static int run_shard(const char *outfile, long days, int index, int count,
+                     uint32_t seed)
+{
+    double start = get_monotonic_ms();
+    if (shard_generate(outfile, days, index, count, seed) != 0)
+        return 1;
+
+    printf("Shard %d of %d: %ld of %ld days (%.1f ms) into: %s\n", index, count,
+           shard_days(days, index, count), days, get_monotonic_ms() - start, outfile);
+    return 0;
+}
+
+// --------------------------------------------------
+// K most extreme hours or days of a text log
+// --------------------------------------------------
+static int run_top_k(const char *filename, int argc, char *argv[], int bottom)
+{
+    ExtremeQuery query;
+    query.bottom = bottom;
+    query.by_day = argc >= 3 && strcmp(argv[2], "days") == 0;
+    query.k = atoi(argv[1]);
+    query.threads = argc == 4 ? atoi(argv[3]) : 1;
+
+    if (parse_weather_metric(argv[0], &query.metric) != 0)
+    {
+        printf("Invalid metric '%s'. Use temp, humidity, wind or avg\n", argv[0]);
+        return 1;
+    }
+    if (argc >= 3 && !query.by_day && strcmp(argv[2], "hours") != 0)
+    {
+        printf("Invalid unit '%s'. Use hours or days\n", argv[2]);
+        return 1;
+    }
+    if (query.k < 1 || query.k > TOPK_MAX || query.threads < 1 ||
+        query.threads > MAX_SCAN_THREADS)
+    {
+        printf("Invalid K or THREADS value. K 1-%d, THREADS 1-%d\n", TOPK_MAX, MAX_SCAN_THREADS);
+        return 1;
+    }
+
+    WeatherSystem weather_system;
+    init_weather_system(&weather_system, 0);
+    ExtremeReading *results = (ExtremeReading *)malloc(sizeof(ExtremeReading) * query.k);
+    if (!results || load_system_logs(&weather_system, filename) < 0)
+    {
+        free(results);
+        destroy_weather_system(&weather_system);
+        return 1;
+    }
+
+    double start = get_monotonic_ms();
+    int found = top_k_query(&weather_system, &query, results);
+    double elapsed = get_monotonic_ms() - start;
+
+    if (found >= 0)
+    {
+        printf("%s %d %s by %s of %d days (%.1f ms, %d threads):\n",
+               bottom ? "Bottom" : "Top", found,
+               query.by_day || query.metric == METRIC_AVG_TEMPERATURE ? "days" : "hours",
+               argv[0], weather_system.days_logged, elapsed, query.threads);
+        for (int i = 0; i < found; i++)
+            print_extreme_reading(&weather_system, &results[i], i + 1, query.metric);
+    }
+
+    free(results);
+    destroy_weather_system(&weather_system);
+    return found < 0 ? 1 : 0;
+}
+
+// --------------------------------------------------
+// Means, variances, covariances and correlations of a text log
+// --------------------------------------------------
+static int run_correlate(const char *filename, int argc, char *argv[])
+{
+    int per_day = 0;
+    const char *from = NULL, *to = NULL;
+    while (argc > 0 && strncmp(argv[0], "--", 2) == 0)
+    {
+        if (strcmp(argv[0], "--days") == 0)
+        {
+            per_day = 1;
+            argc--, argv++;
+        }
+        else if (strcmp(argv[0], "--range") == 0 && argc >= 3)
+        {
+            from = argv[1];
+            to = argv[2];
+            argc -= 3, argv += 3;
+        }
+        else
+            break;
+    }
+    if (argc > 2 || (argc > 0 && strncmp(argv[0], "--", 2) == 0))
+    {
+        printf("Invalid input.\n");
+        return 1;
+    }
+
+    int lag_hours = argc >= 1 ? atoi(argv[0]) : CORRELATION_DEFAULT_LAG;
+    int threads = argc == 2 ? atoi(argv[1]) : 1;
+    if (lag_hours < 1 || threads < 1 || threads > MAX_SCAN_THREADS)
+    {
+        printf("Invalid LAG or THREADS value. LAG >= 1, THREADS 1-%d\n", MAX_SCAN_THREADS);
+        return 1;
+    }
+
+    WeatherSystem weather_system;
+    init_weather_system(&weather_system, 0);
+    if (load_system_logs(&weather_system, filename) < 0)
+    {
+        destroy_weather_system(&weather_system);
+        return 1;
+    }
+
+    // sorts the days by date and drops repeated dates
+    CorrelationReport report;
+    double start = get_monotonic_ms();
+    int status = correlation_report(&weather_system, from, to, lag_hours, threads, &report);
+    double elapsed = get_monotonic_ms() - start;
+    if (status != 0)
+    {
+        destroy_weather_system(&weather_system);
+        return 1;
+    }
+
+    if (per_day)
+    {
+        for (int i = 0; i < weather_system.days_logged; i++)
+        {
+            const char *date_str = weather_system.logs[i].date_str;
+            if ((from && strcmp(date_str, from) < 0) || (to && strcmp(date_str, to) > 0))
+                continue;
+            MetricMoments moments;
+            day_moments(&weather_system.logs[i], &moments);
+            print_day_moments(date_str, &moments);
+        }
+    }
+
+    printf("Correlation of %d days (%.1f ms, %d threads):\n",
+           report.days, elapsed, threads);
+    print_correlation_report(&report);
+
+    destroy_weather_system(&weather_system);
+    return 0;
+}
+
+// --------------------------------------------------
+// Replay simulated stations through the WAL and report latencies
+// --------------------------------------------------
+static int run_loadgen(const char *walfile, int stations, double rate,
+                       double seconds, const char *outfile)
+{
+    // ~35 KB of histogram: keep it off the stack
+    LoadGenReport *report = (LoadGenReport *)malloc(sizeof(LoadGenReport));
+    if (!report)
+    {
+        printf("ERROR: Failed to allocate load report.\n");
+        return 1;
+    }
+
+    printf("Replaying %d stations at %.0f readings/s for %.1f s into WAL: %s\n",
+           stations, rate, seconds, walfile);
+    fflush(stdout);
+
+    // a run that failed part way still reports the readings it made
+    int status = run_load_generator(walfile, outfile, stations, rate, seconds, report);
+    if (status == 0 || report->readings > 0)
+        print_load_report(report);
+    free(report);
+    return status == 0 ? 0 : 1;
+}
@@ -28,6 +28,9 @@
 #ifndef WEATHER_LOGGER_H
 #define WEATHER_LOGGER_H
 
+#include <stdio.h>  // for FILE
+#include <stdint.h> // for fixed width on-disk fields
+
 // --------------------------------------------------
 // constants and macros
 // --------------------------------------------------
@@ -36,6 +39,8 @@
 // has plenty of space for formatting
 #define DAILY_LOG 24 // Hours of the day (0 - 23)
 #define MAX_DAYS 5   // Max storage limit
+#define MAX_ARCHIVE_DAYS 100000 // Max days generated by archive commands
+#define MONTH_LEN 8             // "YYYY-MM" = 7 chars + NULL
 
 #if defined(_MSC_VER)
 #define FOPEN(fptr, filepath, mode) fopen_s(fptr, filepath, mode)
@@ -43,6 +48,85 @@
 #define FOPEN(fptr, filepath, mode) (fptr = fopen(filepath, mode))
 #endif
 
+// flush a stream's OS buffers to stable storage (after fflush())
+#if defined(_WIN32)
+#define FSYNC(fptr) _commit(_fileno(fptr))
+#else
+#define FSYNC(fptr) fsync(fileno(fptr))
+#endif
+
+// Segment store: one text segment per month plus a manifest
+#define SEGMENT_MANIFEST "MANIFEST"
+#define SEGMENT_PATH_LEN 512
+#define MAX_SCAN_THREADS 64
+
+// Zone maps: min/max summaries per block of days
+#define ZONE_BLOCK_DAYS 1024
+#define ZONE_MAP_MAGIC 0x324D5A57u // "WZM2" little endian
+#define MAX_PREDICATES 8
+
+// External sort: days per in-memory run and max runs merged at once
+#define SORT_RUN_DAYS 65536
+#define SORT_MAX_FANIN 128
+#define SORT_MAX_LEVELS 8 // Merge levels: up to SORT_MAX_FANIN^8 runs
+
+// Anomaly detection: rolling windows (in samples) and thresholds
+#define ANOMALY_SHORT_WINDOW 24  // Last 24 hours of hourly readings
+#define ANOMALY_LONG_WINDOW 168  // Last 7 days of hourly readings
+#define ANOMALY_Z_THRESHOLD 3.0  // |z| above this is an anomaly
+#define ANOMALY_EWMA_ALPHA 0.05  // Weight of the newest sample in the EWMA
+#define ANOMALY_METRICS 3        // Temperature, humidity, wind speed
+
+// Columnar export: "WLCOLv1" files, column blocks aligned for mmap
+#define COLUMNAR_MAGIC "WLCOLv1"
+#define COLUMNAR_MAGIC_LEN 8
+#define COLUMNAR_VERSION 1
+#define COLUMNAR_ALIGN 64
+
+// Query server: request operations and limits
+#define QUERY_OP_LATEST 1     // Most recent day
+#define QUERY_OP_DATE 2       // Day with date == from
+#define QUERY_OP_RANGE 3      // Aggregate of days from..to (inclusive)
+#define QUERY_STATUS_OK 0
+#define QUERY_STATUS_NOT_FOUND 1
+#define QUERY_STATUS_BAD_REQUEST 2
+#define QUERY_MAX_EVENTS 256  // epoll events handled per wakeup
+#define QUERY_PIPELINE 16     // Requests buffered per connection
+
+// Shared-memory publisher of the latest readings
+#define SHM_DEFAULT_NAME "/weather_logger"
+#define SHM_MAGIC 0x314D4853u // "SHM1" little endian
+#define SHM_VERSION 1
+#define SHM_SNAPSHOT_TIMEOUT_MS 100 // Give up if the writer stays mid-update
+
+// Write-ahead log: group commit windows and checkpoint interval
+#define WAL_MAGIC 0x314C4157u      // "WAL1" little endian
+#define WAL_MARK_MAGIC 0x314B4357u // "WCK1": checkpoint marker record
+#define WAL_MARK_BEGIN 1           // Checkpoint started (text log size saved)
+#define WAL_MARK_DONE 2            // Checkpoint finished (LSN base of a new WAL)
+#define WAL_GROUP_RECORDS 256      // Max readings per fsync
+#define WAL_GROUP_WINDOW_MS 10.0   // Max wait of a reading before fsync
+#define WAL_CHECKPOINT_DAYS 2      // Completed days between checkpoints
+#define WAL_PATH_LEN 512           // Max length of the WAL's temp file path
+
+// Load generator: log-linear latency histogram (microsecond resolution)
+#define LATENCY_SUB_BITS 7                        // 128 linear steps per power of 2
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BITS) // ~0.8% relative precision
+#define LATENCY_MAX_BITS 40                       // Values up to 2^40 us (~12 days)
+#define LATENCY_BUCKETS (LATENCY_SUB_BUCKETS * (LATENCY_MAX_BITS - LATENCY_SUB_BITS + 1))
+#define LOADGEN_MAX_STATIONS 100000
+
+// Correlation report: default lag of the temperature autocorrelation
+#define CORRELATION_DEFAULT_LAG 24 // Same hour of the next day
+#define CORRELATION_PAIRS 3        // temp-humidity, humidity-wind, temp-wind
+
+// Top-K queries: largest K accepted
+#define TOPK_MAX 1000000
+
+// Sharded generation: day d belongs to shard d % shards
+#define SHARD_DEFAULT_SEED 1u
+#define MAX_SHARDS 256
+
 typedef struct TemperatureLog
 {
     int hour;          // Hour of the day (0 - 23)
@@ -69,6 +153,308 @@ typedef struct WeatherSystem
     int max_days;          // Max storage limit
 } WeatherSystem;
 
+// metrics usable in queries (hourly values, plus the daily average)
+typedef enum WeatherMetric
+{
+    METRIC_TEMPERATURE,
+    METRIC_HUMIDITY,
+    METRIC_WIND_SPEED,
+    METRIC_AVG_TEMPERATURE,
+    METRIC_COUNT
+} WeatherMetric;
+
+// mergeable moments of temperature, humidity and wind (Chan et al.)
+typedef struct MetricMoments
+{
+    double n;                           // Readings
+    double mean[ANOMALY_METRICS];       // Temperature, humidity, wind
+    double m2[ANOMALY_METRICS];         // Sum of squared deviations
+    double comoment[CORRELATION_PAIRS]; // Sum of deviation products per pair
+} MetricMoments;
+
+// mergeable moments of pairs (x[t], x[t + lag]) of hourly temperatures
+typedef struct LagMoments
+{
+    double n;        // Pairs
+    double mean[2];  // Of x[t] and x[t + lag]
+    double m2[2];    // Sum of squared deviations of both
+    double comoment; // Sum of deviation products
+} LagMoments;
+
+typedef struct CorrelationReport
+{
+    MetricMoments moments; // All readings of the range
+    LagMoments lag;        // Temperature autocorrelation pairs
+    int lag_hours;         // Lag in hours (>= 1)
+    int days;              // Days in the range
+} CorrelationReport;
+
+// one result of a top-K query
+typedef struct ExtremeReading
+{
+    float value; // Metric value (hourly reading, or the day's max/min/avg)
+    int day;     // Index of the day in the WeatherSystem
+    int hour;    // Hour of the reading, -1 when whole days are ranked
+} ExtremeReading;
+
+typedef struct ExtremeQuery
+{
+    WeatherMetric metric; // Metric ranked
+    int k;                // Results wanted
+    int bottom;           // 0: largest values first, 1: smallest first
+    int by_day;           // Rank days (their max, or min for bottom) not hours
+    int threads;          // Worker threads (1 .. MAX_SCAN_THREADS)
+} ExtremeQuery;
+
+typedef struct ZoneMap
+{
+    int first_day;           // Index of the block's first day
+    int days;                // Days in the block (<= ZONE_BLOCK_DAYS)
+    long offset;             // Byte offset of the block in its text log
+    float min[METRIC_COUNT]; // Smallest value of each metric in the block
+    float max[METRIC_COUNT]; // Largest value of each metric in the block
+} ZoneMap;
+
+typedef struct ZoneMapIndex
+{
+    ZoneMap *blocks;  // One entry per block of days
+    int count;        // Blocks in use
+    long file_size;   // Size of the text log the offsets refer to
+    int64_t mtime;    // Modification time of that text log (seconds)
+    long mtime_nsec;  // and nanoseconds (0 where not available)
+} ZoneMapIndex;
+
+typedef struct WeatherPredicate
+{
+    WeatherMetric metric; // Metric compared
+    int greater;          // 1: some value > threshold, 0: some value < threshold
+    float threshold;      // Threshold value
+} WeatherPredicate;
+
+typedef struct WeatherFilter
+{
+    WeatherPredicate predicates[MAX_PREDICATES];
+    int count;     // Predicates in use
+    int match_all; // 1: AND of predicates, 0: OR
+} WeatherFilter;
+
+typedef struct SortStats
+{
+    long days_in;    // Days read from the input log
+    long days_out;   // Unique days written
+    long duplicates; // Older copies of repeated dates dropped
+    int runs;        // Sorted runs spilled to temp files
+    int passes;      // Merge passes over the data (levels + final merge)
+} SortStats;
+
+typedef struct RollingWindow
+{
+    float *samples; // Ring buffer of the last capacity samples
+    int capacity;   // Window length in samples
+    int count;      // Samples held (<= capacity)
+    int next;       // Ring slot written next
+    double mean;    // Mean of the samples held
+    double m2;      // Sum of squared deviations from mean
+} RollingWindow;
+
+typedef struct MetricDetector
+{
+    RollingWindow short_window; // e.g. last 24 hours
+    RollingWindow long_window;  // e.g. last 7 days
+    double ewma_mean;           // Exponentially weighted mean
+    double ewma_var;            // Exponentially weighted variance
+    long samples;               // Samples seen by the EWMA
+} MetricDetector;
+
+typedef struct AnomalyDetector
+{
+    MetricDetector metrics[ANOMALY_METRICS]; // One per WeatherMetric < ANOMALY_METRICS
+    double z_threshold;                      // |z| that raises an event
+    long samples;                            // Readings processed
+    long anomalies;                          // Events emitted
+} AnomalyDetector;
+
+typedef struct AnomalyEvent
+{
+    const char *date_str; // Day of the reading
+    int hour;             // Hour of the reading
+    WeatherMetric metric; // Metric that deviated
+    float value;          // The reading
+    double z_short;       // z-score against the short window
+    double z_long;        // z-score against the long window
+    double z_ewma;        // z-score against the EWMA
+} AnomalyEvent;
+
+typedef void (*AnomalyCallback)(AnomalyEvent *event, void *context);
+
+// columns of the columnar export (hourly columns hold DAILY_LOG values per day)
+typedef enum ColumnId
+{
+    COLUMN_DATE,            // char[DATE_LEN] per day
+    COLUMN_TEMPERATURE,     // float per hour
+    COLUMN_HUMIDITY,        // float per hour
+    COLUMN_WIND_SPEED,      // float per hour
+    COLUMN_AVG_TEMPERATURE, // float per day
+    COLUMN_MIN_TEMPERATURE, // float per day
+    COLUMN_MAX_TEMPERATURE, // float per day
+    COLUMN_COUNT
+} ColumnId;
+
+typedef struct ColumnarColumn
+{
+    uint32_t column;    // ColumnId
+    uint32_t elem_size; // Bytes per value
+    uint64_t offset;    // Start of the column block in the file
+    uint64_t count;     // Values in the block
+} ColumnarColumn;
+
+typedef struct ColumnarFile
+{
+    unsigned char *base;                  // Mapped file
+    size_t size;                          // File size
+    uint32_t days;                        // Days stored
+    ColumnarColumn columns[COLUMN_COUNT]; // Footer entries by ColumnId
+} ColumnarFile;
+
+// fixed-size messages of the local query protocol (native byte order)
+typedef struct QueryRequest
+{
+    uint32_t op;         // QUERY_OP_*
+    uint32_t id;         // Echoed back in the response
+    char from[DATE_LEN]; // Date for QUERY_OP_DATE, range start
+    char to[DATE_LEN];   // Range end (inclusive)
+} QueryRequest;
+
+typedef struct QueryResponse
+{
+    uint32_t status;          // QUERY_STATUS_*
+    uint32_t id;              // id of the request
+    uint32_t days;            // Days covered by the answer
+    float avg_temperature;    // Mean of daily averages
+    float min_temperature;    // Lowest temperature
+    float max_temperature;    // Highest temperature
+    float avg_humidity;       // Mean hourly humidity
+    float avg_wind_speed;     // Mean hourly wind speed
+    char date_str[DATE_LEN];  // Day answered, or first day of the range
+} QueryResponse;
+
+// what dashboards see: today's readings so far and running statistics
+typedef struct WeatherSnapshot
+{
+    char date_str[DATE_LEN];           // Day being published
+    uint32_t hours;                    // Readings of that day so far
+    TemperatureLog entries[DAILY_LOG]; // Readings by hour
+    TemperatureLog latest;             // Most recent reading
+    float avg_temperature;             // Running average of the day
+    float min_temperature;             // Running minimum of the day
+    float max_temperature;             // Running maximum of the day
+    uint64_t published;                // Readings published since start
+} WeatherSnapshot;
+
+// layout of the shared-memory object; sequence is the seqlock (accessed
+// with atomics): odd while the writer is updating, even when consistent
+typedef struct SharedWeatherSegment
+{
+    uint32_t magic;           // SHM_MAGIC once initialized
+    uint32_t version;         // SHM_VERSION
+    uint32_t sequence;        // Seqlock counter
+    uint32_t reserved;
+    WeatherSnapshot snapshot; // Guarded by sequence
+} SharedWeatherSegment;
+
+typedef struct WeatherPublisher
+{
+    SharedWeatherSegment *segment; // Mapped shared memory
+    const char *name;              // shm_open() name, e.g. "/weather_logger"
+    WeatherSnapshot local;         // Writer's private copy
+} WeatherPublisher;
+
+typedef struct WeatherReader
+{
+    const SharedWeatherSegment *segment; // Mapped read-only
+    unsigned long retries;               // Snapshots retried (writer was busy)
+} WeatherReader;
+
+typedef struct SegmentInfo
+{
+    char month[MONTH_LEN];     // Partition key "YYYY-MM", file DIR/YYYY-MM.seg
+    int days;                  // Days stored in the segment
+    char first_date[DATE_LEN]; // Earliest date in the segment
+    char last_date[DATE_LEN];  // Latest date in the segment
+} SegmentInfo;
+
+typedef struct SegmentManifest
+{
+    SegmentInfo *segments; // Sorted by month
+    int count;             // Segments in use
+    int capacity;          // Allocated entries
+} SegmentManifest;
+
+typedef struct WalRecord
+{
+    uint32_t magic;          // WAL_MAGIC, marks a written record
+    uint32_t checksum;       // FNV-1a over the rest of the record
+    uint64_t lsn;            // Log sequence number (1, 2, 3 ...)
+    char date_str[DATE_LEN]; // Day the reading belongs to
+    TemperatureLog entry;    // The hourly reading itself
+} WalRecord;
+
+// checkpoint marker, stored in a record slot (same size as WalRecord)
+typedef struct WalMarker
+{
+    uint32_t magic;        // WAL_MARK_MAGIC
+    uint32_t checksum;     // FNV-1a over the rest of the record
+    uint64_t lsn;          // Last LSN covered by the checkpoint
+    int64_t outfile_size;  // Text log size before the checkpoint appended
+    int32_t kind;          // WAL_MARK_BEGIN or WAL_MARK_DONE
+    uint32_t outfile_hash; // FNV-1a of the text log's path (no inodes on Windows)
+    uint64_t outfile_dev;  // st_dev of the text log the BEGIN belongs to
+    uint64_t outfile_ino;  // st_ino of the text log the BEGIN belongs to
+} WalMarker;
+
+typedef struct WriteAheadLog
+{
+    FILE *fptr;                            // WAL file opened for appending
+    const char *filename;                  // Path, kept for truncation
+    WalRecord pending[WAL_GROUP_RECORDS];  // Readings waiting for commit
+    int pending_count;                     // Readings in pending[]
+    double first_pending_ms;               // Arrival of oldest pending reading
+    uint64_t next_lsn;                     // LSN given to the next append
+    uint64_t durable_lsn;                  // Highest LSN known on disk
+    unsigned long syncs;                   // fsync() calls issued
+    int checkpoint_day;                    // First day not yet checkpointed
+} WriteAheadLog;
+
+// HDR-style histogram: exact below LATENCY_SUB_BUCKETS us, then every power
+// of 2 is split into LATENCY_SUB_BUCKETS equal buckets
+typedef struct LatencyHistogram
+{
+    uint64_t counts[LATENCY_BUCKETS]; // Samples per bucket
+    uint64_t total;                   // Samples recorded
+    uint64_t max_us;                  // Exact largest sample
+} LatencyHistogram;
+
+// header of a shard file ("Shard: I of K | Seed: S | Days: D")
+typedef struct ShardInfo
+{
+    int index;          // This shard (0 .. count - 1)
+    int count;          // Shards the run was split into
+    uint32_t seed;      // Seed of the whole run
+    long days;          // Days of the whole run
+    long days_recorded; // Days stored in this file
+} ShardInfo;
+
+typedef struct LoadGenReport
+{
+    LatencyHistogram latency; // Intended send time -> durable in the WAL
+    long readings;            // Readings generated
+    long days;                // Station days completed
+    int stations;             // Simulated stations
+    double target_rate;       // Requested readings/s (0 = unthrottled)
+    double elapsed_ms;        // Wall time of the run
+    unsigned long syncs;      // WAL fsync() calls
+} LoadGenReport;
+
 // --------------------------------------------------
 // forward function declarations/ prototypes
 // --------------------------------------------------
@@ -79,6 +465,8 @@ void display_version(const char *s);
 void get_random_date_str(char *buffer);
 float get_random_float(float min, float max);
 void seed_rnd();
+double get_monotonic_ms(void);
+void sleep_ms(double ms);
 
 // Log In-Memory Storage Module
 void weather_logger(int option, const char *outfile);
@@ -87,11 +475,23 @@ void compute_statistics(DailyWeatherLog *daily_log);
 void add_daily_log(WeatherSystem *weather_system, DailyWeatherLog *daily_log);
 void init_weather_system(WeatherSystem *weather_system, int max_days);
 void destroy_weather_system(WeatherSystem *weather_system);
+int reserve_weather_system(WeatherSystem *weather_system, int max_days);
+int sort_daily_logs(DailyWeatherLog *logs, int count);
+int dedupe_daily_logs(DailyWeatherLog *logs, int count);
 
 // Display Module
 void print_hour_entry(TemperatureLog *temp_log);
 void print_daily_log(DailyWeatherLog *daily_log);
 void print_system_summary(WeatherSystem *system);
+void print_daily_summary(DailyWeatherLog *daily_log);
+void print_anomaly_event(AnomalyEvent *event, void *context);
+void print_query_response(QueryResponse *response);
+void print_weather_snapshot(WeatherSnapshot *snapshot);
+void print_load_report(LoadGenReport *report);
+void print_day_moments(const char *date_str, MetricMoments *moments);
+void print_correlation_report(CorrelationReport *report);
+void print_extreme_reading(WeatherSystem *weather_system, ExtremeReading *reading,
+                           int rank, WeatherMetric metric);
 
 // Random weather simulation module
 float simulate_temperature(int hour);
@@ -104,4 +504,104 @@ void simulate_daily_weather(DailyWeatherLog *daily_log);
 void save_daily_log_to_file(DailyWeatherLog *daily_log, const char *filename);
 void save_system_logs(WeatherSystem *system, const char *filename);
 void append_summary(DailyWeatherLog *daily_log, const char *filename);
+void write_daily_log(FILE *fptr, DailyWeatherLog *daily_log);
+int read_daily_log(FILE *fptr, DailyWeatherLog *daily_log);
+int load_system_logs(WeatherSystem *weather_system, const char *filename);
+
+// Zone Map Module
+float day_metric_min(DailyWeatherLog *daily_log, WeatherMetric metric);
+float day_metric_max(DailyWeatherLog *daily_log, WeatherMetric metric);
+int parse_weather_predicate(const char *text, WeatherPredicate *predicate);
+int parse_weather_metric(const char *name, WeatherMetric *metric);
+int day_matches_filter(DailyWeatherLog *daily_log, WeatherFilter *filter);
+int build_file_zone_maps(const char *filename, ZoneMapIndex *index);
+int save_zone_maps(ZoneMapIndex *index, const char *filename);
+int load_zone_maps(ZoneMapIndex *index, const char *filename);
+void free_zone_maps(ZoneMapIndex *index);
+int zone_map_filter_file(const char *filename, ZoneMapIndex *index,
+                         WeatherFilter *filter, WeatherSystem *out);
+
+// Top-K Query Module
+int top_k_query(WeatherSystem *weather_system, ExtremeQuery *query, ExtremeReading *out);
+
+// Correlation Report Module
+void init_correlation_report(CorrelationReport *report, int lag_hours);
+void day_moments(DailyWeatherLog *daily_log, MetricMoments *moments);
+void merge_metric_moments(MetricMoments *into, MetricMoments *from);
+void merge_correlation_report(CorrelationReport *into, CorrelationReport *from);
+double moments_correlation(MetricMoments *moments, int pair);
+double lag_correlation(LagMoments *lag);
+int correlation_report(WeatherSystem *weather_system, const char *from, const char *to,
+                       int lag_hours, int threads, CorrelationReport *report);
+
+// External Sort Module
+int external_sort_logs(const char *infile, const char *outfile, int run_days,
+                       SortStats *stats);
+
+// Anomaly Detection Module
+int init_anomaly_detector(AnomalyDetector *detector, int short_window,
+                          int long_window, double z_threshold);
+int anomaly_detector_update(AnomalyDetector *detector, const char *date_str,
+                            TemperatureLog *entry, AnomalyCallback callback,
+                            void *context);
+void destroy_anomaly_detector(AnomalyDetector *detector);
+
+// Columnar Export Module
+int save_system_columnar(WeatherSystem *weather_system, const char *filename);
+int columnar_open(ColumnarFile *file, const char *filename);
+const void *columnar_column(ColumnarFile *file, ColumnId column, size_t *count);
+int parse_column_name(const char *name, ColumnId *column);
+void columnar_close(ColumnarFile *file);
+
+// Query Server Module
+int run_query_server(const char *socket_path, WeatherSystem *weather_system);
+int query_client_request(const char *socket_path, QueryRequest *request,
+                         QueryResponse *response);
+int query_load_test(const char *socket_path, int clients, long requests);
+
+// Shared-Memory Publisher Module
+int shm_publisher_open(WeatherPublisher *publisher, const char *name);
+void shm_publish_reading(WeatherPublisher *publisher, const char *date_str,
+                         TemperatureLog *entry);
+void shm_publisher_close(WeatherPublisher *publisher, int remove);
+
+// Shared-Memory Reader Library
+int shm_reader_open(WeatherReader *reader, const char *name);
+int shm_reader_snapshot(WeatherReader *reader, WeatherSnapshot *snapshot);
+void shm_reader_close(WeatherReader *reader);
+
+// Write-Ahead Log Module
+int wal_open(WriteAheadLog *wal, const char *filename);
+uint64_t wal_append(WriteAheadLog *wal, const char *date_str, TemperatureLog *entry);
+int wal_commit(WriteAheadLog *wal);
+int wal_replay(const char *filename, const char *outfile, WeatherSystem *weather_system,
+               DailyWeatherLog *partial, int *partial_hours);
+int wal_checkpoint(WriteAheadLog *wal, WeatherSystem *weather_system,
+                   const char *outfile);
+int wal_commit_expired(WriteAheadLog *wal);
+void wal_close(WriteAheadLog *wal);
+
+// Sharded Generation Module
+uint32_t shard_day_seed(uint32_t seed, long day);
+long shard_days(long days, int index, int count);
+int shard_generate(const char *outfile, long days, int index, int count, uint32_t seed);
+int read_shard_info(FILE *fptr, ShardInfo *info);
+int shard_merge(const char *outfile, int files, char *shard_files[]);
+int shard_run_local(const char *outfile, long days, int count, uint32_t seed);
+
+// Load Generator Module
+void latency_histogram_reset(LatencyHistogram *histogram);
+void latency_histogram_record(LatencyHistogram *histogram, double ms);
+double latency_histogram_percentile(LatencyHistogram *histogram, double percentile);
+int run_load_generator(const char *walfile, const char *outfile, int stations,
+                       double rate, double seconds, LoadGenReport *report);
+
+// Segment Store Module
+int load_segment_manifest(SegmentManifest *manifest, const char *dir);
+int save_segment_manifest(SegmentManifest *manifest, const char *dir);
+void free_segment_manifest(SegmentManifest *manifest);
+int segment_store_append(WeatherSystem *weather_system, const char *dir);
+int segment_store_retain(const char *dir, const char *oldest_month);
+int segment_store_scan(const char *dir, const char *from, const char *to,
+                       int threads, WeatherSystem *out);
 #endif // WEATHER_LOGGER_H
@@ -0,0 +1,484 @@
+// --------------------------------------------------
+// -*- C -*- Compatibility Header
+//
+// Copyright (C) 2023 Developer Jarvis (Pen Name)
+//
+// This file is part of the weather_logger Library. This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// weather_logger - Simulate temperature logs for each hour and save results
+//
+// Author: Developer Jarvis (Pen Name)
+// Contact: https://github.com/DeveloperJarvis
+//
+// --------------------------------------------------
+
+// --------------------------------------------------
+// Zone Map Module
+// --------------------------------------------------
+/*
+ * Responsibilties:
+ * - Summarize each block of ZONE_BLOCK_DAYS days of a text log with the
+ *   min/max of every metric, kept on disk as a FILE.zmap sidecar.
+ * - Threshold filters ("temp>27 or wind>6") that skip whole blocks
+ *   whose min/max cannot match, and only decode the remaining days.
+ *
+ * Functions:
+ * - parse_weather_predicate(const char *text, WeatherPredicate*)
+ * - parse_weather_metric(const char *name, WeatherMetric*)
+ * - day_matches_filter(DailyWeatherLog*, WeatherFilter*)
+ * - build_file_zone_maps(const char *filename, ZoneMapIndex*)
+ * - save_zone_maps(ZoneMapIndex*, const char *filename)
+ * - load_zone_maps(ZoneMapIndex*, const char *filename)
+ * - zone_map_filter_file(const char *filename, ZoneMapIndex*, WeatherFilter*, WeatherSystem*)
+ */
+
+// --------------------------------------------------
+// header files
+// --------------------------------------------------
+#define _POSIX_C_SOURCE 200809L // for stat() and st_mtim in strict C modes
+
+#include <stdio.h>    // for printf(), fopen(), fseek()
+#include <stdlib.h>   // for malloc(), realloc(), free(), strtof()
+#include <string.h>   // for strncmp(), strcmp(), strlen(), memcpy()
+#include <sys/stat.h> // for stat()
+
+#include "weather_logger.h"
+
+// --------------------------------------------------
+// internal helpers
+// --------------------------------------------------
+
+typedef struct ZoneMapFileHeader
+{
+    uint32_t magic;      // ZONE_MAP_MAGIC
+    uint32_t block_days; // ZONE_BLOCK_DAYS used when building
+    int64_t file_size;   // Size of the text log when indexed
+    int64_t mtime;       // Its modification time (seconds)
+    int32_t mtime_nsec;  // and nanoseconds (0 where not available)
+    int32_t count;       // Blocks that follow
+} ZoneMapFileHeader;
+
+// one block on disk: fixed-width fields, whatever the ABI's int and long
+typedef struct ZoneMapFileBlock
+{
+    int32_t first_day;       // Index of the block's first day
+    int32_t days;            // Days in the block
+    int64_t offset;          // Byte offset of the block in the text log
+    float min[METRIC_COUNT]; // Smallest value of each metric
+    float max[METRIC_COUNT]; // Largest value of each metric
+} ZoneMapFileBlock;
+
+static const char *metric_names[METRIC_COUNT] = {"temp", "humidity", "wind", "avg"};
+
+static float hour_metric(TemperatureLog *entry, WeatherMetric metric)
+{
+    switch (metric)
+    {
+    case METRIC_HUMIDITY:
+        return entry->humidity;
+    case METRIC_WIND_SPEED:
+        return entry->wind_speed;
+    default:
+        return entry->temperature;
+    }
+}
+
+static void sidecar_path(char *buffer, size_t size, const char *filename)
+{
+    snprintf(buffer, size, "%s.zmap", filename);
+}
+
+// size and modification time of the text log: a log rewritten to the same
+// size (e.g. by --compact) must not reuse the old min/max
+static int zone_log_stamp(const char *filename, ZoneMapIndex *index)
+{
+    struct stat st;
+    if (stat(filename, &st) != 0)
+        return -1;
+
+    index->file_size = (long)st.st_size;
+    index->mtime = (int64_t)st.st_mtime;
+#if defined(__linux__)
+    index->mtime_nsec = (long)st.st_mtim.tv_nsec;
+#else
+    index->mtime_nsec = 0; // whole seconds only
+#endif
+    return 0;
+}
+
+// start an empty block
+static void zone_map_begin(ZoneMap *zone, int first_day, long offset)
+{
+    zone->first_day = first_day;
+    zone->days = 0;
+    zone->offset = offset;
+    for (int m = 0; m < METRIC_COUNT; m++)
+    {
+        zone->min[m] = 9999.0f;
+        zone->max[m] = -9999.0f;
+    }
+}
+
+// widen a block's ranges with one day
+static void zone_map_add_day(ZoneMap *zone, DailyWeatherLog *daily_log)
+{
+    for (int m = 0; m < METRIC_COUNT; m++)
+    {
+        float lo = day_metric_min(daily_log, (WeatherMetric)m);
+        float hi = day_metric_max(daily_log, (WeatherMetric)m);
+        if (lo < zone->min[m])
+            zone->min[m] = lo;
+        if (hi > zone->max[m])
+            zone->max[m] = hi;
+    }
+    zone->days++;
+}
+
+// append a block to the index, growing it as needed
+static ZoneMap *zone_map_push(ZoneMapIndex *index)
+{
+    if (index->count % 64 == 0)
+    {
+        ZoneMap *blocks = (ZoneMap *)realloc(index->blocks, sizeof(ZoneMap) * (index->count + 64));
+        if (!blocks)
+        {
+            printf("ERROR: Failed to grow zone map index.\n");
+            return NULL;
+        }
+        index->blocks = blocks;
+    }
+    return &index->blocks[index->count++];
+}
+
+static int predicate_may_match(ZoneMap *zone, WeatherPredicate *predicate)
+{
+    if (predicate->greater)
+        return zone->max[predicate->metric] > predicate->threshold;
+    return zone->min[predicate->metric] < predicate->threshold;
+}
+
+// can any day of the block satisfy the filter?
+static int zone_may_match(ZoneMap *zone, WeatherFilter *filter)
+{
+    for (int i = 0; i < filter->count; i++)
+    {
+        int may = predicate_may_match(zone, &filter->predicates[i]);
+        if (filter->match_all && !may)
+            return 0;
+        if (!filter->match_all && may)
+            return 1;
+    }
+    return filter->match_all;
+}
+
+static int keep_match(WeatherSystem *out, DailyWeatherLog *daily_log)
+{
+    if (out->days_logged >= out->max_days &&
+        reserve_weather_system(out, out->max_days * 2 + 1) != 0)
+        return -1;
+    add_daily_log(out, daily_log);
+    return 0;
+}
+
+// --------------------------------------------------
+// predicate functions
+// --------------------------------------------------
+
+// smallest value of a metric over the day
+float day_metric_min(DailyWeatherLog *daily_log, WeatherMetric metric)
+{
+    if (metric == METRIC_AVG_TEMPERATURE)
+        return daily_log->avg_temperature;
+    if (metric == METRIC_TEMPERATURE)
+        return daily_log->min_temperature;
+
+    float min = hour_metric(&daily_log->entries[0], metric);
+    for (int i = 1; i < DAILY_LOG; i++)
+    {
+        float value = hour_metric(&daily_log->entries[i], metric);
+        if (value < min)
+            min = value;
+    }
+    return min;
+}
+
+// largest value of a metric over the day
+float day_metric_max(DailyWeatherLog *daily_log, WeatherMetric metric)
+{
+    if (metric == METRIC_AVG_TEMPERATURE)
+        return daily_log->avg_temperature;
+    if (metric == METRIC_TEMPERATURE)
+        return daily_log->max_temperature;
+
+    float max = hour_metric(&daily_log->entries[0], metric);
+    for (int i = 1; i < DAILY_LOG; i++)
+    {
+        float value = hour_metric(&daily_log->entries[i], metric);
+        if (value > max)
+            max = value;
+    }
+    return max;
+}
+
+// parse "temp>27", "wind>6", "humidity<35", "avg>20"; returns 0 on success
+int parse_weather_predicate(const char *text, WeatherPredicate *predicate)
+{
+    for (int m = 0; m < METRIC_COUNT; m++)
+    {
+        size_t len = strlen(metric_names[m]);
+        if (strncmp(text, metric_names[m], len) != 0 ||
+            (text[len] != '>' && text[len] != '<'))
+            continue;
+
+        char *end;
+        predicate->metric = (WeatherMetric)m;
+        predicate->greater = text[len] == '>';
+        predicate->threshold = strtof(text + len + 1, &end);
+        return (end != text + len + 1 && *end == '\0') ? 0 : -1;
+    }
+    return -1;
+}
+
+// "temp", "humidity", "wind", "avg"; returns 0 if known
+int parse_weather_metric(const char *name, WeatherMetric *metric)
+{
+    for (int m = 0; m < METRIC_COUNT; m++)
+    {
+        if (strcmp(name, metric_names[m]) == 0)
+        {
+            *metric = (WeatherMetric)m;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// a day matches "metric > x" if any of its values is above x (< likewise)
+int day_matches_filter(DailyWeatherLog *daily_log, WeatherFilter *filter)
+{
+    for (int i = 0; i < filter->count; i++)
+    {
+        WeatherPredicate *p = &filter->predicates[i];
+        int match = p->greater ? day_metric_max(daily_log, p->metric) > p->threshold
+                               : day_metric_min(daily_log, p->metric) < p->threshold;
+        if (filter->match_all && !match)
+            return 0;
+        if (!filter->match_all && match)
+            return 1;
+    }
+    return filter->match_all;
+}
+
+// --------------------------------------------------
+// zone map functions
+// --------------------------------------------------
+
+// summarize a text log, remembering where each block starts in the file
+int build_file_zone_maps(const char *filename, ZoneMapIndex *index)
+{
+    memset(index, 0, sizeof(*index));
+
+    FILE *fptr;
+    FOPEN(fptr, filename, "r");
+    if (fptr == NULL)
+    {
+        printf("ERROR: Could not open file '%s' for reading.\n", filename);
+        return -1;
+    }
+
+    // stamped before reading: a log changed meanwhile fails the next load
+    if (zone_log_stamp(filename, index) != 0)
+    {
+        printf("ERROR: Could not stat file '%s'.\n", filename);
+        fclose(fptr);
+        return -1;
+    }
+
+    DailyWeatherLog daily;
+    int day = 0;
+    long offset = ftell(fptr);
+    int status;
+    while ((status = read_daily_log(fptr, &daily)) != 0)
+    {
+        if (status > 0)
+        {
+            if (day % ZONE_BLOCK_DAYS == 0)
+            {
+                // a partial index would be saved and trusted: give up instead
+                ZoneMap *zone = zone_map_push(index);
+                if (!zone)
+                {
+                    fclose(fptr);
+                    free_zone_maps(index);
+                    return -1;
+                }
+                zone_map_begin(zone, day, offset);
+            }
+            zone_map_add_day(&index->blocks[index->count - 1], &daily);
+            day++;
+        }
+        offset = ftell(fptr);
+    }
+
+    fclose(fptr);
+    return index->count;
+}
+
+// write the index next to the text log as FILE.zmap
+int save_zone_maps(ZoneMapIndex *index, const char *filename)
+{
+    char path[SEGMENT_PATH_LEN];
+    sidecar_path(path, sizeof(path), filename);
+
+    FILE *fptr;
+    FOPEN(fptr, path, "wb");
+    if (fptr == NULL)
+    {
+        printf("ERROR: Could not write zone maps '%s'.\n", path);
+        return -1;
+    }
+
+    ZoneMapFileHeader header = {ZONE_MAP_MAGIC, ZONE_BLOCK_DAYS, index->file_size,
+                                index->mtime, (int32_t)index->mtime_nsec, index->count};
+    int ok = fwrite(&header, sizeof(header), 1, fptr) == 1;
+    for (int b = 0; ok && b < index->count; b++)
+    {
+        ZoneMap *zone = &index->blocks[b];
+        ZoneMapFileBlock block;
+        block.first_day = zone->first_day;
+        block.days = zone->days;
+        block.offset = zone->offset;
+        memcpy(block.min, zone->min, sizeof(block.min));
+        memcpy(block.max, zone->max, sizeof(block.max));
+        ok = fwrite(&block, sizeof(block), 1, fptr) == 1;
+    }
+    if (fclose(fptr) != 0)
+        ok = 0;
+    return ok ? 0 : -1;
+}
+
+// read FILE.zmap; fails (so callers rebuild) if missing or FILE changed
+// size or modification time since it was indexed
+int load_zone_maps(ZoneMapIndex *index, const char *filename)
+{
+    memset(index, 0, sizeof(*index));
+
+    char path[SEGMENT_PATH_LEN];
+    sidecar_path(path, sizeof(path), filename);
+
+    ZoneMapIndex current;
+    if (zone_log_stamp(filename, &current) != 0)
+        return -1;
+    long file_size = current.file_size;
+
+    FILE *fptr;
+    FOPEN(fptr, path, "rb");
+    if (fptr == NULL)
+        return -1;
+
+    ZoneMapFileHeader header;
+    if (fread(&header, sizeof(header), 1, fptr) != 1 || header.magic != ZONE_MAP_MAGIC ||
+        header.block_days != ZONE_BLOCK_DAYS || header.file_size != file_size ||
+        header.mtime != current.mtime || header.mtime_nsec != current.mtime_nsec ||
+        header.count < 0)
+    {
+        fclose(fptr);
+        return -1;
+    }
+
+    index->blocks = (ZoneMap *)malloc(sizeof(ZoneMap) * (header.count + 64));
+    if (!index->blocks)
+    {
+        fclose(fptr);
+        return -1;
+    }
+    for (int b = 0; b < header.count; b++)
+    {
+        ZoneMapFileBlock block;
+        if (fread(&block, sizeof(block), 1, fptr) != 1 || block.first_day < 0 ||
+            block.days < 1 || block.days > ZONE_BLOCK_DAYS ||
+            block.offset < 0 || block.offset >= file_size)
+        {
+            fclose(fptr);
+            free_zone_maps(index);
+            return -1;
+        }
+        ZoneMap *zone = &index->blocks[b];
+        zone->first_day = block.first_day;
+        zone->days = block.days;
+        zone->offset = (long)block.offset;
+        memcpy(zone->min, block.min, sizeof(zone->min));
+        memcpy(zone->max, block.max, sizeof(zone->max));
+    }
+    index->count = header.count;
+    index->file_size = file_size;
+    index->mtime = current.mtime;
+    index->mtime_nsec = current.mtime_nsec;
+    fclose(fptr);
+    return index->count;
+}
+
+void free_zone_maps(ZoneMapIndex *index)
+{
+    if (!index)
+        return;
+    free(index->blocks);
+    index->blocks = NULL;
+    index->count = 0;
+}
+
+// copy matching days of a text log into out, skipping blocks the zone maps
+// rule out: only candidate blocks are read; returns blocks scanned, or -1
+int zone_map_filter_file(const char *filename, ZoneMapIndex *index,
+                         WeatherFilter *filter, WeatherSystem *out)
+{
+    FILE *fptr;
+    FOPEN(fptr, filename, "r");
+    if (fptr == NULL)
+    {
+        printf("ERROR: Could not open file '%s' for reading.\n", filename);
+        return -1;
+    }
+
+    int scanned = 0;
+    for (int b = 0; b < index->count; b++)
+    {
+        ZoneMap *zone = &index->blocks[b];
+        if (!zone_may_match(zone, filter))
+            continue;
+
+        scanned++;
+        fseek(fptr, zone->offset, SEEK_SET);
+        DailyWeatherLog daily;
+        int days = 0;
+        int status;
+        while (days < zone->days && (status = read_daily_log(fptr, &daily)) != 0)
+        {
+            if (status < 0)
+                continue;
+            days++;
+            if (day_matches_filter(&daily, filter) && keep_match(out, &daily) != 0)
+            {
+                fclose(fptr);
+                return -1;
+            }
+        }
+    }
+
+    fclose(fptr);
+    return scanned;
+}